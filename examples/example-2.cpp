@@ -29,15 +29,14 @@ int main()
 
     // Initiate printer for strikes K from [K_lower, K_upper]
     double K_lower = 65; double K_upper = 135;
-    PricesPrinter printer(65, 135);
+    PricesPrinter printer(K_lower, K_upper);
 
-    // Show desired put option price K=80
-    double d_K = std::exp(HestonCalculator.get_d_k());
-    printer.set_bounds(K - d_K, K + d_K);
-    printer.to_out(strikes, prices);
+    // Show desired put option price K=80, interpolated from strikes grid
+    Eigen::RowVectorXd quote_strikes = Eigen::RowVectorXd::Constant(1, K);
+    Eigen::RowVectorXd quote_prices = HestonCalculator.calculate_at(option, quote_strikes);
+    printer.to_out(quote_strikes, quote_prices);
 
     // Print option prices to .csv file for K from [K_lower, K_upper]
-    printer.set_bounds(K_lower, K_upper);
     printer.to_csv("plot/example-2", strikes, prices);
 
     return 0;
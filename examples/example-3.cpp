@@ -0,0 +1,54 @@
+#include <iostream>
+
+#include "heston_pricing.h"
+#include "fourier_pricer.h"
+#include "piecewise_heston.h"
+
+int main()
+{
+    // Set market state
+    double r = 0.02;
+    double s_0 = 1;
+    double v_0 = 0.04;
+
+    // Set rho, kappa, theta, sigma
+    HestonParams params = {-0.7, 1.5, 0.04, 0.5};
+
+    // Set calculator parameteres
+    double alpha = 1.5;
+    int N = 4096;               // 2^12
+    double d_u = 0.1;
+
+    // Initiate calculator and pricers of model policies for the same market
+    HestonEuropeanOptionCalculator HestonCalculator(r, s_0, v_0, params, alpha, N, d_u);
+    FourierPricer<HestonModel> HestonPricer(r, s_0, HestonModel(params, v_0), alpha, N, d_u);
+
+    // Piecewise model with equal parameteres on both intervals is the Heston model
+    std::vector<double> times(1, 0.75);
+    std::vector<HestonParams> intervals_params(2, params);
+    FourierPricer<PiecewiseHestonModel> PiecewisePricer(r, s_0, PiecewiseHestonModel(times, intervals_params, v_0),
+                                                        alpha, N, d_u);
+
+    // Compare prices for strikes K from [K_lower, K_upper], far grid strikes are dominated by round-off
+    double K_lower = 0.5; double K_upper = 2;
+    Eigen::RowVectorXd strikes = HestonCalculator.get_log_strike_grid().array().exp();
+    Eigen::Array<bool, 1, Eigen::Dynamic> compared = (strikes.array() >= K_lower) && (strikes.array() <= K_upper);
+
+    // Price surface of call options by maturities, strike doesn't matter
+    double maturities[] = {0.25, 0.5, 1, 2, 5};
+    std::cout << "Max. differences from HestonEuropeanOptionCalculator:" << std::endl;
+    for (int j=0; j<5; j++) {
+        EuropeanOption option(true, maturities[j], 1);
+        Eigen::RowVectorXd prices = HestonCalculator.calculate(option);
+        Eigen::RowVectorXd heston_prices = HestonPricer.calculate(option);
+        Eigen::RowVectorXd piecewise_prices = PiecewisePricer.calculate(option);
+
+        double heston_difference = compared.select((heston_prices - prices).cwiseAbs(), 0).maxCoeff();
+        double piecewise_difference = compared.select((piecewise_prices - prices).cwiseAbs(), 0).maxCoeff();
+        std::cout << "T=" << maturities[j]
+                  << " HestonModel=" << heston_difference
+                  << " PiecewiseHestonModel=" << piecewise_difference << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+
+#include "heston_pricing.h"
+#include "fourier_pricer.h"
+#include "double_heston.h"
+#include "rough_heston.h"
+#include "piecewise_heston.h"
+#include "heston_hull_white.h"
+
+/**
+ * @brief           Price by a copy of a used pricer after the original is destroyed
+ *
+ * @details         Copies must not refer to caches of the original, so repricing by the copy
+ *                  reproduces the prices of the original.
+ *
+ * @return          maximal absolute difference of prices of the original and its copy.
+ */
+template <typename Pricer>
+double copy_difference(Pricer *original, EuropeanOption &option, EuropeanOption &other_option)
+{
+    // Fill caches of the original with two maturities
+    Eigen::RowVectorXd prices = original->calculate(option);
+    original->calculate(other_option);
+
+    Pricer copy(*original);
+    delete original;
+
+    // Cached and evicted maturities of the copy are reused and recalculated
+    copy.calculate(other_option);
+    Eigen::RowVectorXd copy_prices = copy.calculate(option);
+    return (copy_prices - prices).cwiseAbs().maxCoeff();
+}
+
+int main()
+{
+    // Set market state
+    double r = 0.02;
+    double s_0 = 1;
+    double v_0 = 0.04;
+
+    // Set rho, kappa, theta, sigma
+    HestonParams params = {-0.7, 1.5, 0.04, 0.5};
+    HestonParams other_params = {-0.3, 3, 0.06, 0.3};
+
+    // Set calculator parameteres
+    double alpha = 1.5;
+    int N = 1024;               // 2^10
+    double d_u = 0.2;
+
+    // Set options by is_call, maturity, strike
+    EuropeanOption option(true, 1, 1);
+    EuropeanOption other_option(true, 0.5, 1);
+
+    // Initiate pricers holding caches, each is copied and destroyed after use
+    std::vector<double> times(1, 0.75);
+    std::vector<HestonParams> intervals_params;
+    intervals_params.push_back(params);
+    intervals_params.push_back(other_params);
+    HullWhiteParams rates = {0.1, 0.01, 0.3};
+
+    std::cout << "Max. differences of prices by copies of destroyed pricers:" << std::endl;
+    std::cout << "HestonEuropeanOptionCalculator=" << copy_difference(
+        new HestonEuropeanOptionCalculator(r, s_0, v_0, params, alpha, N, d_u), option, other_option
+    ) << std::endl;
+    std::cout << "DoubleHestonModel=" << copy_difference(
+        new FourierPricer<DoubleHestonModel>(r, s_0, DoubleHestonModel(params, v_0, other_params, v_0), alpha, N, d_u),
+        option, other_option
+    ) << std::endl;
+    std::cout << "RoughHestonModel=" << copy_difference(
+        new FourierPricer<RoughHestonModel>(r, s_0, RoughHestonModel(params, 0.1, v_0), alpha, N, d_u),
+        option, other_option
+    ) << std::endl;
+    std::cout << "PiecewiseHestonModel=" << copy_difference(
+        new FourierPricer<PiecewiseHestonModel>(r, s_0, PiecewiseHestonModel(times, intervals_params, v_0),
+                                                alpha, N, d_u),
+        option, other_option
+    ) << std::endl;
+    std::cout << "HestonHullWhiteModel=" << copy_difference(
+        new FourierPricer<HestonHullWhiteModel>(r, s_0, HestonHullWhiteModel(params, v_0, rates), alpha, N, d_u),
+        option, other_option
+    ) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Black-Scholes formulae used for implied volatility quotes and their inversion.
+ */
+#ifndef BLACK_SCHOLES_H
+#define BLACK_SCHOLES_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cfloat>
+#include <Eigen/Dense>
+
+/**
+ * @brief       Get standard normal cumulative distribution function value
+ *
+ * @param   x       Argument value
+ */
+double normal_cdf(double x);
+
+/**
+ * @brief       Get Black-Scholes european option price
+ *
+ * @details     Calculates \f$ s_0N(d_1) - Ke^{-rT}N(d_2) \f$ for call type,
+ *              put price is obtained by Call-Put Parity.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   is_call     Whether option is of call type
+ * @param   s_0         Initial stock price
+ * @param   strike      Strike value
+ * @param   r           Risk-free interest rate
+ * @param   T           Time to maturity
+ * @param   volatility  Black-Scholes volatility
+ *
+ * @return      option price.
+ */
+double black_scholes_price(bool is_call, double s_0, double strike, double r, double T, double volatility);
+
+/**
+ * @brief       Get Black-Scholes implied volatilities of european option prices
+ *
+ * @details     Prices are normalised as in Jaeckel's "Let's Be Rational": with \f$ x = \ln\frac{F}{K} \f$,
+ *              out-of-the-money price \f$ \beta \f$ per \f$ \sqrt{FK} \f$ is inverted from
+ *              \f$ b(x, s) = e^{x/2}N(\frac{x}{s}+\frac{s}{2}) - e^{-x/2}N(\frac{x}{s}-\frac{s}{2}) \f$, \f$ x\leq0 \f$,
+ *              for total volatility \f$ s = \sigma\sqrt{T} \f$. Initial guess is Corrado-Miller rational formula
+ *              (inflection point \f$ s = \sqrt{2|x|} \f$ where it has no real value), then Newton iterations
+ *              on \f$ \ln b(s) = \ln\beta \f$ run on the whole vector at once. Every element keeps a bracket
+ *              of the root and steps leaving it are replaced by bisection, so iterations can not diverge.
+ *              Prices outside of no-arbitrage bounds give NaN.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   strikes     Vector of strikes values
+ * @param   prices      Vector of option prices of strikes shape
+ * @param   T           Time to maturity
+ * @param   r           Risk-free interest rate
+ * @param   s_0         Initial stock price
+ * @param   is_call     Whether options are of call type
+ *
+ * @return      vector of implied volatilities of strikes shape.
+ */
+Eigen::RowVectorXd implied_vols(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &prices,
+    double T,
+    double r,
+    double s_0,
+    bool is_call = true
+);
+
+/**
+ * @brief       Get Black-Scholes implied volatilities of european option prices inside a strike window
+ *
+ * @details     Only strikes of \f$ [K_{lower}, K_{upper}] \f$ (as PricesPrinter interval) are inverted,
+ *              NaN is returned outside of it, so wings of a FFT grid cost nothing.
+ *
+ * @see         implied_vols
+ */
+Eigen::RowVectorXd implied_vols(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &prices,
+    double T,
+    double r,
+    double s_0,
+    bool is_call,
+    double K_lower,
+    double K_upper
+);
+
+#endif  // BLACK_SCHOLES_H
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief Carr-Madan discretization shared by FFT pricers.
+ */
+#ifndef CARR_MADAN_H
+#define CARR_MADAN_H
+
+#include <stdexcept>
+#include <complex>
+#include <cmath>
+#include <Eigen/Dense>
+
+/**
+ * @brief           Check Carr-Madan discretization parameteres
+ *
+ * @details         If alpha or d_u are non-positive or N is non-positive or odd, std::invalid_argument is thrown.
+ *
+ * @param   alpha   Exponent Carr-Madan parameter
+ * @param   N       Integral discretization elements count
+ * @param   d_u     Log forward char. function argument grid step \f$\Delta u>0\f$
+ */
+void check_carr_madan_params(double alpha, int N, double d_u);
+
+/**
+ * @brief           Calculate char. function arguments \f$ w_n = u_n - (\alpha+1)i \f$, \f$ u_n = n\Delta u \f$
+ *
+ * @param   alpha   Exponent Carr-Madan parameter
+ * @param   N       Integral discretization elements count
+ * @param   d_u     Log forward char. function argument grid step \f$\Delta u>0\f$
+ *
+ * @return          vector of arguments of shape N.
+ */
+Eigen::RowVectorXcd carr_madan_arguments(double alpha, int N, double d_u);
+
+/**
+ * @brief           Calculate trapezoid weights divided by Carr-Madan denominator
+ *
+ * @details         Weights are \f$ \frac{1}{\alpha^2 + \alpha - u_n^2 + i(2\alpha+1)u_n} \f$, the one at \f$ u = 0 \f$
+ *                  is halved. Real part of the integrand is even in u, so the rule is spectrally accurate,
+ *                  while the full first weight is a rectangle rule with \f$ \mathcal{O}(\Delta u) \f$ bias.
+ *                  Signs of log strikes grid shift are not applied.
+ *
+ * @param   alpha   Exponent Carr-Madan parameter
+ * @param   N       Integral discretization elements count
+ * @param   d_u     Log forward char. function argument grid step \f$\Delta u>0\f$
+ *
+ * @return          vector of weights of shape N.
+ */
+Eigen::RowVectorXcd carr_madan_weights(double alpha, int N, double d_u);
+
+/**
+ * @brief           Calculate log strikes grid \f$ [-N\Delta k/2, N\Delta k/2) \f$, \f$ \Delta k = \frac{2\pi}{N\Delta u} \f$
+ *
+ * @param   N       Integral discretization elements count
+ * @param   d_u     Log forward char. function argument grid step \f$\Delta u>0\f$
+ *
+ * @return          vector of log strikes of shape N.
+ */
+Eigen::RowVectorXd carr_madan_log_strikes(int N, double d_u);
+
+/**
+ * @brief           Calculate damping factors \f$ \frac{\Delta u}{\pi}e^{-\alpha k} \f$ of transform at log strikes
+ *
+ * @param   alpha       Exponent Carr-Madan parameter
+ * @param   d_u         Log forward char. function argument grid step \f$\Delta u>0\f$
+ * @param   log_strikes Vector of log strikes
+ *
+ * @return          vector of factors of log_strikes shape.
+ */
+Eigen::RowVectorXd carr_madan_damping(double alpha, double d_u, const Eigen::RowVectorXd &log_strikes);
+
+/**
+ * @brief           Calculate european option prices by transform of Carr-Madan integrand into given vector
+ *
+ * @details         Call prices are \f$ B(0,T)\frac{\Delta u}{\pi}e^{-\alpha k}\mathrm{Re}\sum_n\psi_ne^{-iu_nk} \f$,
+ *                  for put type Call-Put Parity is used.
+ *
+ * @param   transform   Transform of integrand at strikes
+ * @param   damping     Damping factors at strikes, see carr_madan_damping()
+ * @param   strikes     Vector of strikes values
+ * @param   df          Discount factor \f$ B(0,T) \f$
+ * @param   s_0         Initial stock price
+ * @param   is_call     Is option of call type
+ * @param   prices      Output vector of prices (resized to strikes shape)
+ */
+void carr_madan_prices(
+    const Eigen::RowVectorXcd &transform,
+    const Eigen::RowVectorXd &damping,
+    const Eigen::RowVectorXd &strikes,
+    double df,
+    double s_0,
+    bool is_call,
+    Eigen::RowVectorXd &prices
+);
+
+#endif  // CARR_MADAN_H
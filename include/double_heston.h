@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @brief Double Heston model (two independent stochastic variance factors) policy of FourierPricer.
+ */
+#ifndef DOUBLE_HESTON_H
+#define DOUBLE_HESTON_H
+
+#include <algorithm>
+
+#include "lru_cache.h"
+#include "heston_model.h"
+
+/**
+ * @brief       Double Heston model policy of FourierPricer
+ *
+ * @details     Variance is a sum of two independent Heston factors \f$ v = v_1 + v_2 \f$, every factor has its own
+ *              \f$ (\rho_j, \kappa_j, \theta_j, \sigma_j) \f$ and initial value, so short and long end of skew term
+ *              structure are fitted by fast and slow factors. Char. function is a product of Heston ones:
+ *              \f$ \ln\varphi(u) = \sum_j C_j(u,T) + D_j(u,T)v_{j,0} \f$.
+ *              Work on a grid of arguments is split into maturity independent and dependent parts.
+ *              Terms \f$ iu \f$ and \f$ iu + u^2 \f$ are shared by factors, and every factor caches
+ *              \f$ b - d \f$, \f$ d \f$ and \f$ g \f$ (square root and division) once per grid, so a maturity costs
+ *              one exponent, one logarithm and a few divisions per factor. Log char. function of every factor is
+ *              cached by maturity (LRU_CACHE_CAPACITY least recently used ones), so changing one factor
+ *              (e.g. during calibration) reprices the other one from cache.
+ *              Moments are finite iff they are finite for both factors.
+ *              See HestonModel for the policy interface.
+ *              Parameteres must be positive, factor index is 0 or 1.
+ */
+class DoubleHestonModel {
+private:
+    //! Heston parameteres structs of factors.
+    HestonParams params[2];
+
+    //! Initial variance values of factors.
+    double v_0[2];
+
+    //! Grid of arguments of cached terms.
+    Eigen::RowVectorXcd grid;
+
+    //! Terms \f$ iu \f$ and \f$ iu + u^2 \f$ at grid shared by factors.
+    Eigen::RowVectorXcd i_u, i_u_u2;
+
+    //! Terms \f$ b - d \f$, \f$ d \f$ and \f$ g = \frac{b-d}{b+d} \f$ of factors at grid, \f$ b = \kappa - \rho\sigma iu \f$.
+    Eigen::RowVectorXcd b_minus_d[2], d[2], g[2];
+
+    //! Log char. functions \f$ C_j + D_jv_{j,0} \f$ of factors at grid by recently priced maturity.
+    LruCache<double, Eigen::RowVectorXcd> factor_cache[2];
+
+    /**
+     * @brief           Calculate maturity independent terms of both factors at a grid of arguments
+     *
+     * @param   u       Grid of complex arguments of char. function
+     */
+    void prepare_grid(const Eigen::RowVectorXcd &u);
+
+    /**
+     * @brief           Calculate maturity independent terms of one factor at grid
+     *
+     * @param   factor  Factor index
+     */
+    void prepare_factor(int factor);
+
+    /**
+     * @brief           Get cached log char. function of one factor at grid
+     *
+     * @param   factor  Factor index
+     * @param   T       Time to maturity
+     */
+    const Eigen::RowVectorXcd &factor_log_cf(int factor, double T);
+
+    /**
+     * @brief           Check factor index
+     *
+     * @details         If index is not 0 or 1, std::invalid_argument is thrown.
+     */
+    static void check_factor(int factor);
+public:
+    /**
+     * @brief           A model constructor
+     *
+     * @details         If v_1 or v_2 are non-positive, std::invalid_argument is thrown.
+     *
+     * @param   first   Heston parameteres struct of the first factor
+     * @param   v_1     Initial variance of the first factor
+     * @param   second  Heston parameteres struct of the second factor
+     * @param   v_2     Initial variance of the second factor
+     */
+    DoubleHestonModel(const HestonParams &first, double v_1, const HestonParams &second, double v_2);
+
+    /**
+     * @brief           Calculate logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$
+     *
+     * @param   u       Grid of complex arguments of char. function
+     * @param   T       Time to maturity
+     * @param   result  Output vector of u shape
+     */
+    void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result);
+
+    /**
+     * @brief           Get critical moments of \f$ \frac{F_T}{F} \f$
+     *
+     * @details         Intersection of heston_critical_moments() of factors.
+     */
+    std::pair<double, double> moment_strip(double T);
+
+    /**
+     * @brief           Heston model parameteres of a factor setter
+     *
+     * @details         Cached terms of the factor are cleared.
+     */
+    void set_params(int factor, const HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres of a factor
+     */
+    HestonParams get_params(int factor);
+
+    /**
+     * @brief           Initial variance of a factor setter
+     *
+     * @details         Cached log char. functions of the factor are cleared.
+     *                  If v_0 is non-positive, std::invalid_argument is thrown.
+     */
+    void set_v0(int factor, double v_0);
+
+    /**
+     * @brief           Get initial variance of a factor
+     */
+    double get_v0(int factor);
+
+    /**
+     * @brief           Clear cached terms and log char. functions of both factors
+     */
+    void clear_cache();
+};
+
+#endif  // DOUBLE_HESTON_H
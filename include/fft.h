@@ -17,7 +17,9 @@
  * @details         Calculates DFT \f$ F_n = \sum_{k=0}^{N-1}f_k e^{-2\pi ink/N}_{N},~ n=\overline{0,N-1} \f$
  *                  by given vector of complex values with even shape $f_k,k=\overline{0,N-1}$.
  *                  If \f$ N=2k+1 \f$ (is odd), exception std::invalid_argument is thrown.
- *                  Time complexity is \f$\mathcal{O}(Nlog(N)) \f$.
+ *                  Radix-2 decimation in time is applied recursively while length is even,
+ *                  remaining odd-length parts \f$ m \f$ are transformed directly.
+ *                  Time complexity is \f$\mathcal{O}(N(log(N) + m)) \f$, i.e. \f$\mathcal{O}(Nlog(N)) \f$ for \f$ N=2^p \f$.
  *                  For references see Project's overleaf page at Main Page.
  *
  * @param   vector  Vector of complex values with even shape.
@@ -26,4 +28,58 @@
  */
 Eigen::RowVectorXcd fft(Eigen::RowVectorXcd &vector);
 
+/**
+ * @brief           Calculate Discrete Fourier Transform of every matrix row by Fast Fourier Transform method
+ *
+ * @details         Batched version of fft(), complex exponents are calculated once and shared by all rows.
+ *                  If rows length is odd, exception std::invalid_argument is thrown.
+ *
+ * @param   matrix  Matrix of complex values with rows of even shape.
+ *
+ * @return          matrix of DFTs of rows.
+ */
+Eigen::MatrixXcd fft(Eigen::MatrixXcd &matrix);
+
+/**
+ * @brief           Calculate complex exponents of fft() of given size
+ *
+ * @details         Exponents \f$ e^{-2\pi ik/N},~ k < N/2 \f$ serve all recursion levels of transform of size N.
+ *
+ * @param   size    Transform size N
+ *
+ * @return          vector of exponents of shape N/2.
+ */
+Eigen::RowVectorXcd fft_twiddles(int size);
+
+/**
+ * @brief           Calculate Discrete Fourier Transform into preallocated vector
+ *
+ * @details         Allocation-free version of fft() for repeated transforms of one size: complex exponents
+ *                  are given by fft_twiddles() and result must be of vector shape and must not alias it.
+ *                  If vector shape is odd or shapes mismatch, exception std::invalid_argument is thrown.
+ *
+ * @param   vector      Vector of complex values with even shape
+ * @param   twiddles    Complex exponents of vector shape
+ * @param   result      Output vector of DFT
+ */
+void fft(const Eigen::RowVectorXcd &vector, const Eigen::RowVectorXcd &twiddles, Eigen::RowVectorXcd &result);
+
+/**
+ * @brief           Calculate trigonometric sum at given points by Goertzel algorithm
+ *
+ * @details         Calculates \f$ F_j = \sum_{n=0}^{N-1}f_n e^{-in\theta_j} \f$ for every \f$ \theta_j \f$
+ *                  by second order recurrence with real coefficient \f$ 2\cos\theta_j \f$.
+ *                  Reinsch modification is used (recurrence on differences for \f$ \cos\theta_j\geq0 \f$
+ *                  and on sums otherwise), so rounding errors do not grow near \f$ \theta_j = 0, \pi \f$.
+ *                  DFT bin n of fft() is obtained for \f$ \theta = 2\pi n/N \f$.
+ *                  Time complexity is \f$ \mathcal{O}(NM) \f$ for M points, so it is cheaper than fft()
+ *                  only for a handful of points.
+ *
+ * @param   vector  Vector of complex coefficients \f$ f_n \f$
+ * @param   phases  Vector of points \f$ \theta_j \f$
+ *
+ * @return          vector of sums of phases shape.
+ */
+Eigen::RowVectorXcd goertzel(const Eigen::RowVectorXcd &vector, const Eigen::RowVectorXd &phases);
+
 #endif  // FFT_H
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ * @file
+ * @brief Carr-Madan FFT pricer of european options templated by model policy.
+ */
+#ifndef FOURIER_PRICER_H
+#define FOURIER_PRICER_H
+
+#include <complex>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+#include "fft.h"
+#include "carr_madan.h"
+#include "heston_model.h"
+#include "european_options.h"
+
+/**
+ * @brief               A Carr-Madan FFT pricer of european options for any model with known char. function
+ *
+ * @details             Model policy supplies batch kernel of log char. function and its moment strip,
+ *                      see HestonModel for the interface. Calls are resolved at compile time, so there is no virtual
+ *                      dispatch in the pipeline. Everything independent of maturity (argument grid
+ *                      \f$ w_n = u_n - (\alpha+1)i \f$, trapezoid weights divided by Carr-Madan denominator
+ *                      with alternating signs of grid shift, damping factors \f$ e^{-\alpha k} \f$, FFT complex exponents)
+ *                      is calculated once per grid, and integrand and transform are written into preallocated buffers,
+ *                      so calculate() into a caller's vector does not allocate apart from the model kernel itself.
+ *                      Discretization (see carr_madan.h) is shared with HestonEuropeanOptionCalculator,
+ *                      so log strikes grid and prices of Heston model are the same.
+ *                      Integral discretization elements count must be even.
+ *                      Other parameteres must be positive.
+ *
+ * @tparam  Model       Model policy, Heston model by default
+ */
+template <typename Model = HestonModel>
+class FourierPricer {
+private:
+    //! Risk-free interest rate.
+    double r;
+
+    //! Initial stock price.
+    double s_0;
+
+    //! Model policy.
+    Model model;
+
+    //! Exponent Carr-Madan parameter.
+    double alpha;
+
+    //! Integral discretization elements count.
+    int N;
+
+    //! Log forward char. function argument grid step \f$\Delta u>0\f$.
+    double d_u;
+
+    //! Char. function arguments \f$ w_n = u_n - (\alpha+1)i \f$.
+    Eigen::RowVectorXcd arguments;
+
+    //! Trapezoid weights divided by Carr-Madan denominator, signs alternate to shift log strikes grid.
+    Eigen::RowVectorXcd weights;
+
+    //! Phases \f$ iu_n \f$ of log forward.
+    Eigen::RowVectorXcd phases;
+
+    //! Damping factors \f$ \frac{\Delta u}{\pi}e^{-\alpha k_j} \f$ of log strikes grid.
+    Eigen::RowVectorXd damping;
+
+    //! Strikes \f$ e^{k_j} \f$ of log strikes grid.
+    Eigen::RowVectorXd strikes;
+
+    //! Complex exponents of FFT of size N.
+    Eigen::RowVectorXcd twiddles;
+
+    //! Buffers of integrand and its transform.
+    Eigen::RowVectorXcd integrand, transform;
+public:
+    /**
+     * @brief           A pricer constructor
+     *
+     * @details         If r or s_0 are non-positive, std::invalid_argument is thrown.
+     *
+     * @param   r       Risk-free interest rate.
+     * @param   s_0     Initial stock price.
+     * @param   model   Model policy.
+     * @param   alpha   Exponent Carr-Madan parameter.
+     * @param   N       Integral discretization elements count.
+     * @param   d_u     Log forward char. function argument grid step \f$\Delta u>0\f$.
+     */
+    FourierPricer(double r, double s_0, const Model &model, double alpha, int N, double d_u);
+
+    /**
+     * @brief           Calculator parameters setter
+     *
+     * @details         Grid dependent buffers are recalculated. If alpha or d_u are non-positive
+     *                  or N is non-positive or odd, std::invalid_argument is thrown.
+     */
+    void set_calculator_params(double alpha, int N, double d_u);
+
+    /**
+     * @brief           Get model policy, e.g. to change its parameters
+     */
+    Model &get_model();
+
+    /**
+     * @brief           Get log strike grid \f$ [-N\Delta k/2, N\Delta k/2) \f$
+     */
+    Eigen::RowVectorXd get_log_strike_grid();
+
+    /**
+     * @brief           Calculate european option prices at log strikes grid into given vector
+     *
+     * @details         Prices are \f$ B(0,T)\frac{\Delta u}{\pi}e^{-\alpha k}\mathrm{Re}\sum_n\psi(u_n)e^{-iu_nk} \f$ with
+     *                  \f$ \psi = e^{\ln\varphi(w) + iw\ln F}\cdot\mathrm{weight} \f$, for put type Call-Put Parity is used.
+     *                  If moment \f$ \alpha+1 \f$ is infinite at maturity, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   prices  Output vector of prices (resized to N)
+     */
+    void calculate(EuropeanOption &option, Eigen::RowVectorXd &prices);
+
+    /**
+     * @brief           Calculate european option prices at log strikes grid
+     *
+     * @return          vector of prices of shape N.
+     */
+    Eigen::RowVectorXd calculate(EuropeanOption &option);
+};
+
+template <typename Model>
+FourierPricer<Model>::FourierPricer(
+    double _r,
+    double _s_0,
+    const Model &_model,
+    double alpha,
+    int N,
+    double d_u
+) : model(_model) {
+    if (_r <= 0) {
+        throw std::invalid_argument("Risk-free rate must be non-negative.");
+    }
+    if (_s_0 <= 0) {
+        throw std::invalid_argument("Starting spot price must be non-negative.");
+    }
+    r = _r; s_0 = _s_0;
+    set_calculator_params(alpha, N, d_u);
+}
+
+template <typename Model>
+void FourierPricer<Model>::set_calculator_params(double _alpha, int _N, double _d_u)
+{
+    check_carr_madan_params(_alpha, _N, _d_u);
+    alpha = _alpha; N = _N; d_u = _d_u;
+
+    std::complex<double> i(0.0, 1.0);
+    arguments = carr_madan_arguments(alpha, N, d_u);
+    phases = (i * Eigen::RowVectorXd::LinSpaced(N, 0, (N-1) * d_u).array()).matrix();
+
+    // Alternating signs shift log strikes grid to [-N*d_k/2, N*d_k/2)
+    weights = carr_madan_weights(alpha, N, d_u);
+    weights(Eigen::seq(1, N - 1, 2)) *= -1.0;
+
+    Eigen::RowVectorXd log_strikes = get_log_strike_grid();
+    damping = carr_madan_damping(alpha, d_u, log_strikes);
+    strikes = log_strikes.array().exp().matrix();
+    twiddles = fft_twiddles(N);
+    integrand.resize(N);
+    transform.resize(N);
+}
+
+template <typename Model>
+Model &FourierPricer<Model>::get_model()
+{
+    return model;
+}
+
+template <typename Model>
+Eigen::RowVectorXd FourierPricer<Model>::get_log_strike_grid()
+{
+    return carr_madan_log_strikes(N, d_u);
+}
+
+template <typename Model>
+void FourierPricer<Model>::calculate(EuropeanOption &option, Eigen::RowVectorXd &prices)
+{
+    double T = option.get_maturity();
+    if (alpha + 1 >= model.moment_strip(T).second) {
+        throw std::invalid_argument("Moment of damped price is infinite.");
+    }
+
+    // Char. function of ln F_T is exp(ln phi(w) + iw ln F), iw ln F = (alpha + 1) ln F + iu ln F
+    double log_forward = std::log(s_0) + r * T;
+    model.log_cf(arguments, T, integrand);
+    integrand = (
+        (integrand.array() + (alpha + 1) * log_forward + log_forward * phases.array()).exp() * weights.array()
+    ).matrix();
+    fft(integrand, twiddles, transform);
+    carr_madan_prices(transform, damping, strikes, std::exp(-r * T), s_0, option.is_call(), prices);
+}
+
+template <typename Model>
+Eigen::RowVectorXd FourierPricer<Model>::calculate(EuropeanOption &option)
+{
+    Eigen::RowVectorXd prices(N);
+    calculate(option, prices);
+    return prices;
+}
+
+#endif  // FOURIER_PRICER_H
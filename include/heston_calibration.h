@@ -0,0 +1,301 @@
+/**
+ * @file
+ * @brief Heston model calibration to market quotes.
+ */
+#ifndef HESTON_CALIBRATION_H
+#define HESTON_CALIBRATION_H
+
+#include <vector>
+#include <map>
+#include <thread>
+#include <random>
+#include <limits>
+
+#include "parallel.h"
+#include "black_scholes.h"
+#include "heston_pricing.h"
+
+/**
+ * @brief       A market quote of european option
+ *
+ * @details     Quote value is either option price or Black-Scholes implied volatility.
+ *              Strike, maturity and value must be positive, weight must be non-negative.
+ */
+struct MarketQuote
+{
+    //! Strike value
+    double strike;
+
+    //! Time to maturity
+    double maturity;
+
+    //! Option price or implied volatility
+    double value;
+
+    //! Whether value is implied volatility
+    bool is_implied_volatility;
+
+    //! Weight of quote in least squares
+    double weight;
+
+    //! Option type. True if Call (otherwise Put)
+    bool is_call;
+};
+
+/**
+ * @brief       A result of Heston model calibration
+ */
+struct CalibrationResult
+{
+    //! Calibrated Heston model parameteres
+    HestonParams params;
+
+    //! Calibrated initial volatility value
+    double v_0;
+
+    //! Root mean square of weighted price residuals
+    double rmse;
+
+    //! Performed iterations count
+    int iterations;
+};
+
+/**
+ * @brief               A class of Heston model calibrator by Levenberg-Marquardt method
+ *
+ * @details             Parameters \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$ minimize weighted sum of squared
+ *                      price residuals. Implied volatility quotes are converted to prices by Black-Scholes formula.
+ *                      Every iteration prices maturities in parallel: prices and analytic Jacobian
+ *                      are evaluated at quotes strikes by one HestonEuropeanOptionCalculator::calculate_jacobian_at()
+ *                      call per maturity (direct summation by default, so there is no interpolation error).
+ *                      Quotes are grouped by maturity once, so their strikes are reused across iterations.
+ *                      Parameteres are kept inside admissible bounds, steps with infinite moments
+ *                      (Andersen-Piterbarg condition is false) are rejected.
+ *                      Without a good initial guess calibrate_global() searches the bounds by differential evolution
+ *                      and polishes the best parameteres found.
+ *                      Jumps of SVJJ (Bates) model set by set_jumps() are held fixed, Heston parameteres are
+ *                      calibrated under them.
+ *                      Integral discretization elements count must be even.
+ *                      Other parameteres must be positive.
+ */
+class HestonCalibrator {
+private:
+    //! Risk-free interest rate.
+    double r;
+
+    //! Initial stock price.
+    double s_0;
+
+    //! Exponent Carr-Madan parameter.
+    double alpha;
+
+    //! Integral discretization elements count.
+    int N;
+
+    //! Log forward char. function argument grid step \f$\Delta u>0\f$.
+    double d_u;
+
+    //! Market quotes.
+    std::vector<MarketQuote> quotes;
+
+    //! Fixed jumps parameteres struct (no jumps by default).
+    JumpParams jumps;
+
+    //! Jump price transform at \f$ w_n = u_n - (\alpha+1)i \f$, shared by all calculators (empty without jumps).
+    Eigen::RowVectorXcd jump_transform;
+
+    //! Market prices of quotes.
+    Eigen::VectorXd market_prices;
+
+    //! Square roots of quotes weights.
+    Eigen::VectorXd sqrt_weights;
+
+    //! Distinct maturities of quotes.
+    std::vector<double> maturities;
+
+    //! Quotes indices of every maturity.
+    std::vector<std::vector<int> > maturity_quotes;
+
+    //! Strikes of quotes of every maturity.
+    std::vector<Eigen::RowVectorXd> maturity_strikes;
+
+    //! Direct summation kernels \f$ e^{-iu_n\ln K_j} \f$ of every maturity.
+    std::vector<Eigen::MatrixXcd> maturity_kernels;
+
+    //! Calculators of every maturity, reused across iterations.
+    std::vector<HestonEuropeanOptionCalculator> calculators;
+
+    //! Method of prices evaluation at quotes strikes.
+    StrikesEvaluation strikes_evaluation;
+
+    //! Maximal iterations count.
+    int max_iterations;
+
+    //! Threads count used to price maturities.
+    int threads_count;
+
+    /**
+     * @brief           Calculate model prices and Jacobian of quotes of one maturity
+     *
+     * @details         Rows of quotes of the maturity are written, so maturities could be priced in parallel.
+     *                  Parameteres are set to the calculator of the maturity, it is not constructed again.
+     *
+     * @param   index       Maturity index
+     * @param   x           Parameters vector \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$
+     * @param   prices      Vector of model prices of all quotes
+     * @param   jacobian    Jacobian of model prices of all quotes
+     */
+    void evaluate_maturity(int index, const Eigen::VectorXd &x, Eigen::VectorXd &prices, Eigen::MatrixXd &jacobian);
+
+    /**
+     * @brief           Calculate weighted residuals and their Jacobian
+     *
+     * @param   x           Parameters vector \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$
+     * @param   residuals   Vector of weighted residuals
+     * @param   jacobian    Jacobian of weighted residuals
+     *
+     * @return          false if any maturity could not be priced (e.g. moments are infinite).
+     */
+    bool evaluate(const Eigen::VectorXd &x, Eigen::VectorXd &residuals, Eigen::MatrixXd &jacobian);
+
+    /**
+     * @brief           Calculate weighted squared residuals of quotes of one maturity for all population members
+     *
+     * @details         Row of the maturity is written, so maturities could be priced in parallel.
+     *                  Integrands of all members are calculated by one batch heston_log_price_cf() call
+     *                  and summed at quotes strikes by one product with the maturity summation kernel.
+     *                  Members with infinite moments get infinite residuals.
+     *
+     * @param   index       Maturity index
+     * @param   population  Matrix of parameters vectors \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$ by columns
+     * @param   costs       Matrix of residuals of maturities (rows) and members (columns)
+     */
+    void evaluate_maturity_population(int index, const Eigen::MatrixXd &population, Eigen::MatrixXd &costs);
+
+    /**
+     * @brief           Calculate weighted sums of squared residuals for all population members
+     *
+     * @details         Maturities are evaluated on worker threads, an exception of any of them is rethrown.
+     *
+     * @param   population  Matrix of parameters vectors \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$ by columns
+     *
+     * @return          vector of sums of population size.
+     */
+    Eigen::VectorXd evaluate_population(const Eigen::MatrixXd &population);
+public:
+    /**
+     * @brief           A calibrator constructor
+     *
+     * @details         If r or s_0 are non-positive or quotes are empty or invalid, std::invalid_argument is thrown.
+     *                  Carr-Madan parameteres are checked by HestonEuropeanOptionCalculator.
+     *
+     * @param   r       Risk-free interest rate.
+     * @param   s_0     Initial stock price.
+     * @param   quotes  Market quotes.
+     * @param   alpha   Exponent Carr-Madan parameter.
+     * @param   N       Integral discretization elements count.
+     * @param   d_u     Log forward char. function argument grid step \f$\Delta u>0\f$.
+     */
+    HestonCalibrator(
+        double r,
+        double s_0,
+        const std::vector<MarketQuote> &quotes,
+        double alpha,
+        int N,
+        double d_u
+    );
+
+    /**
+     * @brief           Maximal iterations count setter
+     *
+     * @details         If iterations count is non-positive, std::invalid_argument is thrown.
+     */
+    void set_max_iterations(int max_iterations);
+
+    /**
+     * @brief           Get maximal iterations count
+     */
+    int get_max_iterations();
+
+    /**
+     * @brief           Threads count setter
+     *
+     * @details         If threads count is non-positive, std::invalid_argument is thrown.
+     *                  By default it is hardware concurrency.
+     */
+    void set_threads_count(int threads_count);
+
+    /**
+     * @brief           Get threads count
+     */
+    int get_threads_count();
+
+    /**
+     * @brief           Set method of prices evaluation at quotes strikes
+     *
+     * @details         Quotes strikes must lie inside the log strike grid for spline and NUFFT evaluations.
+     */
+    void set_strikes_evaluation(StrikesEvaluation evaluation);
+
+    /**
+     * @brief           Get method of prices evaluation at quotes strikes
+     */
+    StrikesEvaluation get_strikes_evaluation();
+
+    /**
+     * @brief           Fixed jumps parameteres setter
+     *
+     * @details         Jumps part of char. function is added to Heston one, so SVJJ (Bates) model is calibrated
+     *                  with given jumps. Jacobian of Levenberg-Marquardt steps does not differentiate
+     *                  variance jumps part w.r.t. Heston parameteres (steps are accepted by exact residuals).
+     *                  If jumps are invalid, std::invalid_argument is thrown (see check_jump_params()).
+     */
+    void set_jumps(const JumpParams &jumps);
+
+    /**
+     * @brief           Get fixed jumps parameteres
+     */
+    JumpParams get_jumps();
+
+    /**
+     * @brief           Get market prices of quotes
+     */
+    Eigen::VectorXd get_market_prices();
+
+    /**
+     * @brief           Calibrate Heston model parameteres by Levenberg-Marquardt method
+     *
+     * @details         Step solves \f$ (J^TJ + \lambda\,\mathrm{diag}(J^TJ))\delta = -J^Tr \f$,
+     *                  damping \f$ \lambda \f$ decreases after accepted steps and increases after rejected ones.
+     *                  Iterations stop when relative decrease of residuals or relative step is below \f$ 10^{-6} \f$.
+     *                  If initial parameteres could not be priced, std::invalid_argument is thrown.
+     *
+     * @param   params  Initial Heston model parameteres
+     * @param   v_0     Initial volatility value guess
+     *
+     * @return          calibration result.
+     */
+    CalibrationResult calibrate(HestonParams &params, double v_0);
+
+    /**
+     * @brief           Calibrate Heston model parameteres by global search
+     *
+     * @details         Differential evolution (DE/rand/1/bin) explores flat valleys of the objective
+     *                  starting from uniform population inside wide admissible ranges, so no initial guess is needed.
+     *                  Every generation is priced at once: maturities are distributed among threads and each one
+     *                  prices all members by batch char. function (direct summation, regardless of
+     *                  get_strikes_evaluation()). Evolution stops after given generations count or when residuals
+     *                  of the whole population are close, then the best member is polished by calibrate().
+     *                  If population size is less than 4 or generations count is negative,
+     *                  std::invalid_argument is thrown.
+     *
+     * @param   population_size Count of parameters sets in population
+     * @param   generations     Maximal generations count
+     * @param   seed            Seed of random numbers generator
+     *
+     * @return          calibration result of the polishing step.
+     */
+    CalibrationResult calibrate_global(int population_size, int generations, unsigned int seed = 0);
+};
+
+#endif  // HESTON_CALIBRATION_H
@@ -0,0 +1,140 @@
+/**
+ * @file
+ * @brief Class of european options Heston model calculator by COS method.
+ */
+#ifndef HESTON_COS_H
+#define HESTON_COS_H
+
+#include <utility>
+
+#include "heston_model.h"
+#include "european_options.h"
+
+//! Default cosine series terms count, prices are accurate to about 1e-10 with the default truncation width.
+#define HESTON_COS_TERMS 256
+
+//! Default truncation range width in standard deviations.
+#define HESTON_COS_WIDTH 10
+
+/**
+ * @brief               A class of Heston model european options calculator by COS method
+ *
+ * @details             Fang-Oosterlee COS method: the density of \f$ z = \ln(S_T/F_0) \f$ is expanded
+ *                      into a cosine series on truncation range \f$ [a,b] \f$ given by Heston cumulants.
+ *                      Unlike HestonEuropeanOptionCalculator it prices arbitrary strikes, which is
+ *                      preferable for small strike sets. Series converges exponentially: with L = 10 and typical
+ *                      parameteres price errors are about 1e-4 with 64 terms, 1e-7 with 128 terms and 1e-10
+ *                      with 256 terms, hence HESTON_COS_TERMS terms are used by default. Wider truncation ranges
+ *                      need more terms.
+ *                      Series terms count and truncation width must be positive.
+ *                      Other parameteres must be positive.
+ */
+class HestonCosCalculator {
+private:
+    //! Risk-free interest rate.
+    double r;
+
+    //! Initial stock price.
+    double s_0;
+
+    //! Initial volatility value.
+    double v_0;
+
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Cosine series terms count.
+    int N;
+
+    //! Truncation range width in standard deviations.
+    double L;
+
+    /**
+     * @brief           Calculate discount factor \f$ B(t,T)e^{-r(T-t)} \f$.
+     *
+     * @param   t       Current time value
+     * @param   T       Terminal time value
+     */
+    double df(double t, double T);
+public:
+    /**
+     * @brief           A calculator constructor
+     *
+     * @details         If r or s_0 or v_0 are non-positive, std::invalid_argument is thrown.
+     *
+     * @param   r       Risk-free interest rate.
+     * @param   s_0     Initial stock price.
+     * @param   v_0     Initial volatility value.
+     * @param   params  Heston model parameteres struct.
+     * @param   N       Cosine series terms count.
+     * @param   L       Truncation range width in standard deviations.
+     */
+    HestonCosCalculator(
+        double r,
+        double s_0,
+        double v_0,
+        HestonParams &params,
+        int N = HESTON_COS_TERMS,
+        double L = HESTON_COS_WIDTH
+    );
+
+    /**
+     * @brief           A calculator parameteres (N, L) setter
+     *
+     * @details         If N or L are non-positive, std::invalid_argument is thrown.
+     */
+    void set_calculator_params(int N, double L);
+
+    /**
+     * @brief           Get cosine series terms count
+     */
+    int get_N();
+
+    /**
+     * @brief           Get truncation range width in standard deviations
+     */
+    double get_L();
+
+    /**
+     * @brief           Get first four cumulants of \f$ z = \ln(S_T/F_0) \f$
+     *
+     * @details         Cumulants are exact Taylor coefficients of \f$ \ln\varphi \f$ at zero,
+     *                  which solve the Heston Riccati ODE order by order (integrated by RK4).
+     *
+     * @param   T       Time to maturity
+     *
+     * @return          vector \f$ (c_1, c_2, c_3, c_4) \f$.
+     */
+    Eigen::Vector4d get_cumulants(double T);
+
+    /**
+     * @brief           Get truncation range of \f$ z = \ln(S_T/F_0) \f$
+     *
+     * @details         Range is \f$ [c_1 - L\sqrt{c_2 + \sqrt{c_4}}, c_1 + L\sqrt{c_2 + \sqrt{c_4}}] \f$,
+     *                  where \f$ c_n \f$ are Heston cumulants of \f$ z \f$ (see get_cumulants).
+     *
+     * @param   T       Time to maturity
+     *
+     * @return          pair of lower and upper range bounds.
+     *
+     * @see             Fang, Oosterlee (2008), A novel pricing method for European options based on Fourier-cosine series expansions
+     */
+    std::pair<double, double> get_truncation_range(double T);
+
+    /**
+     * @brief           Calculate european option prices at given strikes by COS method
+     *
+     * @details         Put prices are calculated by the cosine series, call prices are obtained by Call-Put Parity.
+     *                  Char. function is evaluated once per call, all strikes are then priced
+     *                  by a single matrix-vector product.
+     *                  If any strike is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     *
+     * @return          vector of prices of strikes shape.
+     */
+    Eigen::RowVectorXd calculate(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+};
+
+#endif  // HESTON_COS_H
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief Heston-Hull-White (H1-HW) stochastic rates model policy of FourierPricer.
+ */
+#ifndef HESTON_HULL_WHITE_H
+#define HESTON_HULL_WHITE_H
+
+#include "lru_cache.h"
+#include "heston_model.h"
+#include "quadrature.h"
+
+/**
+ * @brief       A short rate parameteres struct of Hull-White model
+ *
+ * @details     Short rate follows \f$ dr = \lambda(\theta(t) - r)dt + \eta dW_r \f$, where \f$ \theta(t) \f$ fits
+ *              the initial discount curve, and \f$ dW_rdW_x = \rho_{xr}dt \f$ for stock Brownian motion \f$ W_x \f$.
+ *              Rates are independent of variance. Mean reversion and volatility must be positive, correlation
+ *              is in [-1, 1] (see check_hull_white_params()).
+ */
+struct HullWhiteParams
+{
+    //! Mean reversion speed
+    double lambda;
+
+    //! Short rate volatility
+    double eta;
+
+    //! Correlation of stock and short rate
+    double rho;
+};
+
+/**
+ * @brief       Check Hull-White parameteres
+ *
+ * @details     If mean reversion or volatility are non-positive, or correlation is outside of [-1, 1],
+ *              std::invalid_argument is thrown.
+ */
+void check_hull_white_params(const HullWhiteParams &rates);
+
+/**
+ * @brief       Heston-Hull-White model policy of FourierPricer
+ *
+ * @details     Under T-forward measure \f$ x = \ln F(t,T) \f$ has variance rate \f$ v + \eta^2B^2 - 2\rho_{xr}\eta B\sqrt{v} \f$,
+ *              \f$ B(t,T) = \frac{e^{-\lambda(T-t)} - 1}{\lambda} \f$. H1-HW approximation of Grzelak and Oosterlee
+ *              replaces \f$ \sqrt{v} \f$ in the cross term by \f$ \mathbb{E}\sqrt{v(t)} \f$, so the model is affine and
+ *              \f$ \ln\varphi(u,T) = C(u,T) + D(u,T)v_0 - \frac{iu+u^2}{2}\Sigma(T) \f$ with Heston \f$ C, D \f$ of
+ *              heston_cf_coefficients() and deterministic variance of rates
+ *              \f$ \Sigma(T) = \int_0^T\eta^2B(t,T)^2 - 2\rho_{xr}\eta B(t,T)\mathbb{E}\sqrt{v(t)}\,dt \f$.
+ *              The first term is integrated in closed form, the second one by Gauss-Legendre rule, where
+ *              \f$ \mathbb{E}\sqrt{v(t)} \f$ is the series of noncentral chi-squared distribution of \f$ v(t) \f$
+ *              (delta method when its noncentrality is large, i.e. at short times). \f$ \Sigma(T) \f$ does not
+ *              depend on u and is cached for LRU_CACHE_CAPACITY recent maturities, so rates cost one vector
+ *              operation per maturity beside the Heston kernel and a surface is priced by one FFT per maturity.
+ *              Drift \f$ \theta(t) \f$ fits the flat curve of pricer's rate, so pricer's discount factor and forward
+ *              are exact. Rates do not change critical moments of Heston model.
+ *              Parameteres must be positive, see HestonModel for the policy interface.
+ */
+class HestonHullWhiteModel {
+private:
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Initial variance value.
+    double v_0;
+
+    //! Hull-White parameteres struct.
+    HullWhiteParams rates;
+
+    //! Gauss-Legendre nodes and weights on [-1, 1] of rates variance integral.
+    Eigen::RowVectorXd nodes, weights;
+
+    //! Buffers of affine coefficients.
+    Eigen::RowVectorXcd C, D;
+
+    //! Variances of rates \f$ \Sigma(T) \f$ by recently priced maturity.
+    LruCache<double, double> variance_cache;
+
+    /**
+     * @brief           Get expected volatility \f$ \mathbb{E}\sqrt{v(t)} \f$
+     *
+     * @param   t       Time
+     */
+    double expected_volatility(double t);
+public:
+    /**
+     * @brief           A model constructor
+     *
+     * @details         If v_0 is non-positive or Hull-White parameteres are invalid, std::invalid_argument is thrown.
+     *
+     * @param   params  Heston model parameteres struct
+     * @param   v_0     Initial variance value
+     * @param   rates   Hull-White parameteres struct
+     */
+    HestonHullWhiteModel(const HestonParams &params, double v_0, const HullWhiteParams &rates);
+
+    /**
+     * @brief           Calculate logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$ under T-forward measure
+     *
+     * @param   u       Grid of complex arguments of char. function
+     * @param   T       Time to maturity
+     * @param   result  Output vector of u shape
+     */
+    void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result);
+
+    /**
+     * @brief           Get critical moments of \f$ \frac{F_T}{F} \f$
+     *
+     * @see             heston_critical_moments
+     */
+    std::pair<double, double> moment_strip(double T);
+
+    /**
+     * @brief           Get variance of rates \f$ \Sigma(T) \f$
+     *
+     * @param   T       Time to maturity
+     */
+    double rates_variance(double T);
+
+    /**
+     * @brief           Heston model parameteres setter
+     *
+     * @details         Cached variances of rates are cleared.
+     */
+    void set_params(const HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres
+     */
+    HestonParams get_params();
+
+    /**
+     * @brief           Initial variance value setter
+     *
+     * @details         Cached variances of rates are cleared. If v_0 is non-positive, std::invalid_argument is thrown.
+     */
+    void set_v0(double v_0);
+
+    /**
+     * @brief           Get initial variance value
+     */
+    double get_v0();
+
+    /**
+     * @brief           Hull-White parameteres setter
+     *
+     * @details         Cached variances of rates are cleared. If parameteres are invalid, std::invalid_argument
+     *                  is thrown (see check_hull_white_params()).
+     */
+    void set_rates(const HullWhiteParams &rates);
+
+    /**
+     * @brief           Get Hull-White parameteres
+     */
+    HullWhiteParams get_rates();
+};
+
+#endif  // HESTON_HULL_WHITE_H
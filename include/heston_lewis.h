@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Class of european options Heston model calculator by Lewis formula.
+ */
+#ifndef HESTON_LEWIS_H
+#define HESTON_LEWIS_H
+
+#include "quadrature.h"
+#include "black_scholes.h"
+#include "heston_model.h"
+#include "european_options.h"
+
+/**
+ * @brief               A class of Heston model european options calculator by Lewis formula
+ *
+ * @details             Call price is given by single-integral Lewis formula
+ *                      \f$ C = C_{BS} + \frac{\sqrt{FK}B(0,T)}{\pi}\int_0^\infty
+ *                      \mathrm{Re}\left[e^{iuk}(\varphi_{BS}(u-\frac{i}{2})-\varphi(u-\frac{i}{2}))\right]\frac{du}{u^2+1/4} \f$,
+ *                      \f$ k = \ln(F/K) \f$, with Black-Scholes control variate of the same expected variance.
+ *                      The integral is approximated by Gauss-Laguerre quadrature, char. function values at
+ *                      quadrature nodes are calculated once per maturity, so every strike costs one dot product.
+ *                      Nodes count must be positive and not greater than 128.
+ *                      Other parameteres must be positive.
+ */
+class HestonLewisCalculator {
+private:
+    //! Risk-free interest rate.
+    double r;
+
+    //! Initial stock price.
+    double s_0;
+
+    //! Initial volatility value.
+    double v_0;
+
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Gauss-Laguerre nodes count.
+    int N;
+
+    //! Gauss-Laguerre nodes.
+    Eigen::RowVectorXd nodes;
+
+    //! Gauss-Laguerre weights multiplied by exponent of nodes.
+    Eigen::RowVectorXd weights;
+
+    //! Maturity of cached integrand (non-positive if cache is empty).
+    double cached_T;
+
+    //! Integration variable values at quadrature nodes for cached maturity.
+    Eigen::RowVectorXd cached_u;
+
+    //! Weighted integrand without strike exponent for cached maturity.
+    Eigen::RowVectorXcd cached_integrand;
+
+    //! Black-Scholes control variate variance for cached maturity.
+    double cached_variance;
+
+    /**
+     * @brief           Calculate discount factor \f$ B(t,T)e^{-r(T-t)} \f$.
+     *
+     * @param   t       Current time value
+     * @param   T       Terminal time value
+     */
+    double df(double t, double T);
+
+    /**
+     * @brief           Calculate char. function values at quadrature nodes for maturity T
+     *
+     * @details         Does nothing if values for T are already cached.
+     *
+     * @param   T       Time to maturity
+     */
+    void prepare(double T);
+public:
+    /**
+     * @brief           A calculator constructor
+     *
+     * @details         If r or s_0 or v_0 are non-positive, std::invalid_argument is thrown.
+     *
+     * @param   r       Risk-free interest rate.
+     * @param   s_0     Initial stock price.
+     * @param   v_0     Initial volatility value.
+     * @param   params  Heston model parameteres struct.
+     * @param   N       Gauss-Laguerre nodes count.
+     */
+    HestonLewisCalculator(
+        double r,
+        double s_0,
+        double v_0,
+        HestonParams &params,
+        int N
+    );
+
+    /**
+     * @brief           A calculator nodes count setter
+     *
+     * @details         If N is non-positive or greater than 128, std::invalid_argument is thrown.
+     *                  Cached char. function values are dropped.
+     */
+    void set_calculator_params(int N);
+
+    /**
+     * @brief           Get Gauss-Laguerre nodes count
+     */
+    int get_N();
+
+    /**
+     * @brief           Get scale of Gauss-Laguerre nodes for maturity T
+     *
+     * @details         Integration variable values are nodes multiplied by the scale,
+     *                  which is not greater than 1 and shrinks for slowly decaying char. functions.
+     *
+     * @param   T       Time to maturity
+     */
+    double get_node_scale(double T);
+
+    /**
+     * @brief           Calculate european option prices at given strikes by Lewis formula
+     *
+     * @details         Call prices are calculated, for put type Call-Put Parity is used.
+     *                  If any strike is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     *
+     * @return          vector of prices of strikes shape.
+     */
+    Eigen::RowVectorXd calculate(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Calculate european option price at option's strike by Lewis formula
+     *
+     * @param   option  European option with given time to maturity, strike and type
+     *
+     * @return          option price.
+     */
+    double calculate(EuropeanOption &option);
+};
+
+#endif  // HESTON_LEWIS_H
@@ -7,6 +7,12 @@
 
 #include <complex>
 #include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <Eigen/Dense>
 
 /**
  * @brief       A Heston model parameteres struct
@@ -30,10 +36,85 @@ struct HestonParams
     double sigma;
 };
 
+/**
+ * @brief       A batch of Heston model parameteres stored as structure of arrays
+ *
+ * @details     Every parameter of HestonParams is a vector over parameter sets, so batch kernels
+ *              evaluate neighbouring parameter sets in SIMD lanes at the same char. function argument.
+ *              Elements of structure must be positive and of the same size.
+ */
+struct HestonParamsBatch
+{
+    //! Correlations between brownian motions
+    Eigen::ArrayXd rho;
+
+    //! Speeds of mean-reversion
+    Eigen::ArrayXd kappa;
+
+    //! Long-term means
+    Eigen::ArrayXd theta;
+
+    //! Volatilities of volatility
+    Eigen::ArrayXd sigma;
+
+    /**
+     * @brief       A batch constructor
+     *
+     * @param   size    Count of parameter sets
+     */
+    explicit HestonParamsBatch(int size = 0);
+
+    /**
+     * @brief       Get count of parameter sets
+     */
+    int size() const;
+
+    /**
+     * @brief       Set parameter set of given index
+     */
+    void set(int index, const HestonParams &params);
+
+    /**
+     * @brief       Get parameter set of given index
+     */
+    HestonParams get(int index) const;
+};
+
+/**
+ * @brief       A jumps parameteres struct of SVJJ (Bates) model
+ *
+ * @details     Heston model with simultaneous jumps of price and variance (Duffie, Pan and Singleton):
+ *              jumps arrive with intensity \f$ \lambda \f$, variance jump is exponential with mean \f$ \mu_v \f$,
+ *              log price jump is \f$ \mathcal{N}(\mu_s + \rho_J Z_v, \sigma_s^2) \f$ given variance jump \f$ Z_v \f$.
+ *              Bates model is \f$ \mu_v = 0 \f$, Heston model is \f$ \lambda = 0 \f$.
+ *              Intensity, variance jump mean and log price jump deviation must be non-negative,
+ *              \f$ \rho_J\mu_v < 1 \f$ (see check_jump_params()).
+ */
+struct JumpParams
+{
+    //! Jumps intensity
+    double lambda;
+
+    //! Mean of log price jump without variance jump
+    double mu_s;
+
+    //! Standard deviation of log price jump
+    double sigma_s;
+
+    //! Mean of variance jump
+    double mu_v;
+
+    //! Sensitivity of log price jump to variance jump
+    double rho_j;
+};
+
 /**
  * @brief       Get char. function of \f$ X_T = \ln F_T \f$
  *
  * @details     Calculates char. function of \f$ X_T = \ln F_T \f$ by given formulae.
+ *              The "little Heston trap" form of Albrecher et al. is used, i.e.
+ *              \f$ g = \frac{\kappa-\rho\sigma iu-d}{\kappa-\rho\sigma iu+d} \f$ together with \f$ e^{-d\tau} \f$,
+ *              so the complex logarithm stays on its principal branch for long maturities.
  *              For references see Project's overleaf page at Main Page.
  *           
  * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
@@ -75,4 +156,562 @@ heston_log_price_cf(std::complex<double> u, double x, double v, double t, double
 std::complex<double>
 heston_exp_option_cf(std::complex<double> u, double x, double v, double alpha, double T, HestonParams &params);
 
+/**
+ * @brief       Get explosion time of moment \f$ \mathbb{E}F_T^{\omega} \f$
+ *
+ * @details     By Andersen and Piterbarg moment is finite until the solution of Riccati equation
+ *              \f$ D' = \frac{\sigma^2}{2}D^2 + (\rho\sigma\omega-\kappa)D + \frac{\omega(\omega-1)}{2},~ D(0) = 0 \f$
+ *              explodes. With \f$ b = \rho\sigma\omega-\kappa \f$ and \f$ \Delta = b^2 - \sigma^2\omega(\omega-1) \f$:
+ *                  1) if \f$ \Delta\geq0 \f$ and \f$ b<0 \f$, moment never explodes,
+ *                  2) if \f$ \Delta\geq0 \f$ and \f$ b>0 \f$, \f$ T^* = \frac{1}{\gamma}\ln\frac{b+\gamma}{b-\gamma},~ \gamma = \sqrt{\Delta} \f$,
+ *                  3) if \f$ \Delta<0 \f$, \f$ T^* = \frac{2}{\gamma}\left(\pi\mathbb{1}_{b<0} + \arctan\frac{\gamma}{b}\right),~ \gamma = \sqrt{-\Delta} \f$.
+ *              Moments of \f$ \omega\in[0,1] \f$ are always finite.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   omega   Moment order
+ * @param   params  Heston model parameters struct
+ *
+ * @return      explosion time, infinity if moment is finite at all maturities.
+ */
+double heston_moment_explosion_time(double omega, HestonParams &params);
+
+/**
+ * @brief       Get critical moments of \f$ F_T \f$
+ *
+ * @details     Moments \f$ \mathbb{E}F_T^{\omega} \f$ are finite for \f$ \omega\in(\omega_-,\omega_+) \f$, where
+ *              \f$ \omega_-\leq0 \f$ and \f$ \omega_+\geq1 \f$ solve \f$ T^*(\omega) = T \f$
+ *              (see heston_moment_explosion_time()). Explosion time is monotone in \f$ \omega \f$ outside of [0, 1],
+ *              so roots are bracketed by doubling and found by bisection.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   T       Time to expiration
+ * @param   params  Heston model parameters struct
+ *
+ * @return      pair of \f$ \omega_- \f$ and \f$ \omega_+ \f$, infinite if moments of that side never explode.
+ */
+std::pair<double, double> heston_critical_moments(double T, HestonParams &params);
+
+/**
+ * @brief       Get explosion time of moment Riccati equation started at a given value
+ *
+ * @details     Solution of \f$ D' = \frac{\sigma^2}{2}D^2 + bD + \frac{\omega(\omega-1)}{2},~ D(0) = D_0 \f$ explodes at
+ *              the time of heston_moment_explosion_time() formulas with \f$ b \f$ replaced by \f$ b + \sigma^2D_0 \f$,
+ *              if \f$ \Delta\geq0 \f$ it explodes iff \f$ b + \sigma^2D_0 > \sqrt{\Delta} \f$.
+ *              Moment explosion time is the case of \f$ D_0 = 0 \f$.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   omega   Moment order
+ * @param   D_0     Initial value of Riccati equation
+ * @param   params  Heston model parameters struct
+ *
+ * @return      explosion time, infinity if solution never explodes.
+ */
+double heston_riccati_explosion_time(double omega, double D_0, HestonParams &params);
+
+/**
+ * @brief       Get solution of moment Riccati equation started at a given value
+ *
+ * @details     Real solution \f$ D(\tau) \f$ of the equation of heston_riccati_explosion_time() before
+ *              its explosion time.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   omega   Moment order
+ * @param   D_0     Initial value of Riccati equation
+ * @param   tau     Time \f$ \tau \f$ less than explosion time
+ * @param   params  Heston model parameters struct
+ */
+double heston_riccati_moment_solution(double omega, double D_0, double tau, HestonParams &params);
+
+/**
+ * @brief       Check if moment of Heston model with piecewise constant parameteres is finite
+ *
+ * @details     Parameteres are constant on intervals \f$ (t_{j-1}, t_j] \f$, \f$ t_0 = 0 \f$, the last interval is
+ *              unbounded. Riccati equation runs backward from maturity: on every interval it starts at the value
+ *              reached on the later one (see heston_riccati_moment_solution()), and moment is finite iff no interval
+ *              is longer than its explosion time (see heston_riccati_explosion_time()).
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   omega   Moment order
+ * @param   T       Time to expiration
+ * @param   times   Increasing ends \f$ t_1, \dots, t_{n-1} \f$ of bounded intervals
+ * @param   params  Heston model parameters structs of n intervals
+ */
+bool piecewise_heston_moment_finite(
+    double omega,
+    double T,
+    std::vector<double> &times,
+    std::vector<HestonParams> &params
+);
+
+/**
+ * @brief       Get critical moments of \f$ F_T \f$ of Heston model with piecewise constant parameteres
+ *
+ * @details     Critical moments of piecewise_heston_moment_finite(), see heston_critical_moments().
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   T       Time to expiration
+ * @param   times   Increasing ends \f$ t_1, \dots, t_{n-1} \f$ of bounded intervals
+ * @param   params  Heston model parameters structs of n intervals
+ *
+ * @return      pair of \f$ \omega_- \f$ and \f$ \omega_+ \f$, infinite if moments of that side never explode.
+ */
+std::pair<double, double> piecewise_heston_critical_moments(
+    double T,
+    std::vector<double> &times,
+    std::vector<HestonParams> &params
+);
+
+/**
+ * @brief       Get affine coefficients \f$ C(u,\tau), D(u,\tau) \f$ of char. function on a grid
+ *
+ * @details     Batch kernel behind heston_log_price_cf: for every element of u calculates
+ *              \f$ C \f$ and \f$ D \f$ such that \f$ \varphi(u) = e^{C + Dv + iux} \f$.
+ *              The rotation-count-free form of Albrecher et al. is used (see heston_log_price_cf),
+ *              hence coarse u grids remain valid for long maturities and high vol-of-vol.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u       Grid of complex arguments of char. function
+ * @param   tau     Time to expiration \f$ \tau = T - t \f$
+ * @param   params  Heston model parameters struct
+ * @param   C       Output vector of \f$ C(u,\tau) \f$ values (resized to u)
+ * @param   D       Output vector of \f$ D(u,\tau) \f$ values (resized to u)
+ *
+ * @see             Project's overleaf page at Main Page
+ */
+void heston_cf_coefficients(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    HestonParams &params,
+    Eigen::RowVectorXcd &C,
+    Eigen::RowVectorXcd &D
+);
+
+/**
+ * @brief       Get affine coefficients of char. function and their gradient w.r.t. Heston parameters on a grid
+ *
+ * @details     Calculates \f$ C, D \f$ as heston_cf_coefficients and gradient of \f$ \ln\varphi = C + Dv + iux \f$
+ *              w.r.t. \f$ (v, \rho, \kappa, \theta, \sigma) \f$ by chain rule through the same intermediates
+ *              \f$ b = \kappa - \rho\sigma iu \f$, \f$ d \f$, \f$ g \f$, \f$ e^{-d\tau} \f$:
+ *              \f$ d_p = \frac{bb_p + \sigma\sigma_p(iu + u^2)}{d} \f$, \f$ g_p = \frac{2(b_pd - bd_p)}{(b+d)^2} \f$, etc.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u           Grid of complex arguments of char. function
+ * @param   tau         Time to expiration \f$ \tau = T - t \f$
+ * @param   v           Volatility value at current time
+ * @param   params      Heston model parameters struct
+ * @param   C           Output vector of \f$ C(u,\tau) \f$ values (resized to u)
+ * @param   D           Output vector of \f$ D(u,\tau) \f$ values (resized to u)
+ * @param   gradient    Output matrix of 5 rows of derivatives of \f$ \ln\varphi \f$ w.r.t.
+ *                      \f$ v, \rho, \kappa, \theta, \sigma \f$ (resized to u)
+ *
+ * @see             Project's overleaf page at Main Page
+ */
+void heston_cf_gradient(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    double v,
+    HestonParams &params,
+    Eigen::RowVectorXcd &C,
+    Eigen::RowVectorXcd &D,
+    Eigen::MatrixXcd &gradient
+);
+
+/**
+ * @brief       Get char. function of \f$ X_T = \ln F_T \f$ on a grid of arguments
+ *
+ * @details     Vectorised version of heston_log_price_cf built on heston_cf_coefficients.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u       Grid of complex arguments of char. function
+ * @param   x       Log forward value at current time
+ * @param   v       Volatility value at current time
+ * @param   t       Market current time
+ * @param   T       Time to expiration
+ * @param   params  Heston model parameters struct
+ *
+ * @return      vector of char. function values of shape of u.
+ */
+Eigen::RowVectorXcd
+heston_log_price_cf(const Eigen::RowVectorXcd &u, double x, double v, double t, double T, HestonParams &params);
+
+/**
+ * @brief       Get char. function of \f$ c_T(k) = e^{\alpha k}\mathbb{E}[(F_T-K)^+] \f$ on a grid of arguments
+ *
+ * @details     Vectorised version of heston_exp_option_cf built on heston_cf_coefficients.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u       Grid of real arguments of char. function
+ * @param   x       Log forward value at current time
+ * @param   v       Volatility value at current time
+ * @param   alpha   Exponent parameter
+ * @param   T       Time to expiration
+ * @param   params  Heston model parameters struct
+ *
+ * @return      vector of char. function values of shape of u.
+ */
+Eigen::RowVectorXcd
+heston_exp_option_cf(const Eigen::RowVectorXcd &u, double x, double v, double alpha, double T, HestonParams &params);
+
+/**
+ * @brief       Get affine coefficients \f$ C(u,\tau), D(u,\tau) \f$ of char. function for a batch of parameter sets
+ *
+ * @details     "Vertical" version of heston_cf_coefficients: complex arithmetic is done on separate real and
+ *              imaginary arrays, which are column-major with parameter sets along columns, so at every u
+ *              the parameter sets are contiguous and fill SIMD lanes of packet operations (square roots,
+ *              divisions, exponents and logarithms). Throughput does not depend on the grid size then.
+ *              Lanes width is the vector width of the build (2 doubles for SSE2, 4 for AVX).
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u       Grid of complex arguments of char. function
+ * @param   tau     Time to expiration \f$ \tau = T - t \f$
+ * @param   params  Batch of Heston model parameters
+ * @param   C       Output matrix of \f$ C(u,\tau) \f$ values, parameter sets by rows (resized)
+ * @param   D       Output matrix of \f$ D(u,\tau) \f$ values, parameter sets by rows (resized)
+ *
+ * @see             heston_cf_coefficients
+ */
+void heston_cf_coefficients(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    const HestonParamsBatch &params,
+    Eigen::MatrixXcd &C,
+    Eigen::MatrixXcd &D
+);
+
+/**
+ * @brief       Get char. function of \f$ X_T = \ln F_T \f$ on a grid of arguments for a batch of parameter sets
+ *
+ * @details     Batch version of heston_log_price_cf built on batch heston_cf_coefficients.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u       Grid of complex arguments of char. function
+ * @param   x       Log forward value at current time
+ * @param   v       Volatility values at current time of every parameter set
+ * @param   t       Market current time
+ * @param   T       Time to expiration
+ * @param   params  Batch of Heston model parameters
+ *
+ * @return      matrix of char. function values, parameter sets by rows and u by columns.
+ */
+Eigen::MatrixXcd heston_log_price_cf(
+    const Eigen::RowVectorXcd &u,
+    double x,
+    const Eigen::ArrayXd &v,
+    double t,
+    double T,
+    const HestonParamsBatch &params
+);
+
+/**
+ * @brief       Check jumps parameteres
+ *
+ * @details     If intensity, variance jump mean or log price jump deviation are negative or
+ *              \f$ \rho_J\mu_v \geq 1 \f$, std::invalid_argument is thrown.
+ */
+void check_jump_params(const JumpParams &jumps);
+
+/**
+ * @brief       Get char. function \f$ e^{iu\mu_s - \sigma_s^2u^2/2} \f$ of log price jump without variance jump
+ *
+ * @details     Factor does not depend on maturity, so it is calculated once per grid of arguments and passed
+ *              to svjj_jump_coefficient() of every maturity.
+ *
+ * @param   u       Grid of complex arguments of char. function
+ * @param   jumps   Jumps parameteres struct
+ *
+ * @return      vector of values of shape of u.
+ */
+Eigen::RowVectorXcd jump_price_transform(const Eigen::RowVectorXcd &u, JumpParams &jumps);
+
+/**
+ * @brief       Get jumps part \f$ J(u,\tau) \f$ of char. function of SVJJ model on a grid
+ *
+ * @details     Char. function of SVJJ model is \f$ \varphi(u) = e^{C + J + Dv + iux} \f$ with Heston
+ *              \f$ C, D \f$ of heston_cf_coefficients() and
+ *              \f$ J = \lambda\left(\hat\phi_s(u)\int_0^\tau\frac{ds}{1 - \mu_v(iu\rho_J + D(u,s))}
+ *              - \tau - iu\bar{k}\tau\right) \f$, where \f$ \hat\phi_s \f$ is jump_price_transform() and
+ *              \f$ \bar{k} = \frac{e^{\mu_s+\sigma_s^2/2}}{1-\rho_J\mu_v} - 1 \f$ compensates jumps of forward.
+ *              Integral is in closed form. Its logarithm is split into the one of Heston \f$ C \f$ and
+ *              \f$ \ln\frac{1-\mu_v(iu\rho_J+D)}{1-\mu_v iu\rho_J} \f$, so it stays on principal branch
+ *              as the Heston one. For Bates model \f$ \mu_v = 0 \f$ integral is \f$ \tau \f$,
+ *              so \f$ J \f$ is linear in maturity and Heston intermediates are not calculated.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u           Grid of complex arguments of char. function
+ * @param   tau         Time to expiration \f$ \tau = T - t \f$
+ * @param   params      Heston model parameters struct
+ * @param   jumps       Jumps parameteres struct
+ * @param   transform   Values of jump_price_transform() at u
+ * @param   J           Output vector of \f$ J(u,\tau) \f$ values (resized to u)
+ */
+void svjj_jump_coefficient(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    HestonParams &params,
+    JumpParams &jumps,
+    const Eigen::RowVectorXcd &transform,
+    Eigen::RowVectorXcd &J
+);
+
+/**
+ * @brief       Get derivative \f$ \partial_\tau J(u,\tau) \f$ of jumps part of char. function on a grid
+ *
+ * @details     Derivative is the integrand of svjj_jump_coefficient() at \f$ \tau \f$:
+ *              \f$ \lambda\left(\frac{\hat\phi_s(u)}{1 - \mu_v(iu\rho_J + D(u,\tau))} - 1 - iu\bar{k}\right) \f$.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u           Grid of complex arguments of char. function
+ * @param   D           Heston coefficient \f$ D(u,\tau) \f$ at u
+ * @param   jumps       Jumps parameteres struct
+ * @param   transform   Values of jump_price_transform() at u
+ *
+ * @return      vector of derivative values of shape of u.
+ */
+Eigen::RowVectorXcd svjj_jump_rate(
+    const Eigen::RowVectorXcd &u,
+    const Eigen::RowVectorXcd &D,
+    JumpParams &jumps,
+    const Eigen::RowVectorXcd &transform
+);
+
+/**
+ * @brief       Check whether moment \f$ \mathbb{E}\left(\frac{F_T}{F}\right)^{\omega} \f$ of SVJJ model is finite
+ *
+ * @details     Moment is finite if Heston moment is finite (heston_moment_explosion_time() is greater than T) and
+ *              variance jumps transform is finite, i.e. \f$ 1 - \mu_v(\omega\rho_J + D(-i\omega,\tau)) > 0 \f$
+ *              for \f$ \tau\in[0,T] \f$. Real \f$ D \f$ is monotone in \f$ \tau \f$, so both ends are checked.
+ *              Lognormal price jumps have all moments finite.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   omega   Moment order
+ * @param   T       Time to expiration
+ * @param   params  Heston model parameters struct
+ * @param   jumps   Jumps parameteres struct
+ */
+bool svjj_moment_finite(double omega, double T, HestonParams &params, JumpParams &jumps);
+
+/**
+ * @brief       Get critical moments of \f$ F_T \f$ of SVJJ model
+ *
+ * @details     Moments are finite on an interval \f$ (\omega_-,\omega_+) \f$ containing [0, 1] (see
+ *              svjj_moment_finite()), its bounds are bracketed by doubling and found by bisection as in
+ *              heston_critical_moments(). Bates and Heston models have the same critical moments.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   T       Time to expiration
+ * @param   params  Heston model parameters struct
+ * @param   jumps   Jumps parameteres struct
+ *
+ * @return      pair of \f$ \omega_- \f$ and \f$ \omega_+ \f$, infinite if moments of that side never explode.
+ */
+std::pair<double, double> svjj_critical_moments(double T, HestonParams &params, JumpParams &jumps);
+
+/**
+ * @brief       Get char. function of \f$ X_T = \ln F_T \f$ of SVJJ (Bates) model on a grid of arguments
+ *
+ * @details     Heston char. function of heston_cf_coefficients() multiplied by \f$ e^J \f$ of
+ *              svjj_jump_coefficient(). Jump price transform is calculated by the call, reuse it across maturities
+ *              by svjj_jump_coefficient() directly.
+ *
+ * @warning     There is no input parameres check. Be cautious to use this function outside of this project.
+ *
+ * @param   u       Grid of complex arguments of char. function
+ * @param   x       Log forward value at current time
+ * @param   v       Volatility value at current time
+ * @param   t       Market current time
+ * @param   T       Time to expiration
+ * @param   params  Heston model parameters struct
+ * @param   jumps   Jumps parameteres struct
+ *
+ * @return      vector of char. function values of shape of u.
+ */
+Eigen::RowVectorXcd svjj_log_price_cf(
+    const Eigen::RowVectorXcd &u,
+    double x,
+    double v,
+    double t,
+    double T,
+    HestonParams &params,
+    JumpParams &jumps
+);
+
+/**
+ * @brief       Heston model policy of FourierPricer
+ *
+ * @details     Model policy of FourierPricer is a class with two methods:
+ *                  1) void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result) calculates
+ *                     logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$ on a grid of complex arguments
+ *                     into preallocated vector of u shape,
+ *                  2) std::pair<double, double> moment_strip(double T) returns critical moments \f$ \omega_\pm \f$,
+ *                     so \f$ \mathbb{E}(F_T/F)^{\omega} \f$ is finite for \f$ \omega\in(\omega_-,\omega_+) \f$.
+ *              Heston policy is \f$ C(u,T) + D(u,T)v_0 \f$ of heston_cf_coefficients() and heston_critical_moments().
+ *              Parameteres must be positive.
+ */
+class HestonModel {
+private:
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Initial volatility value.
+    double v_0;
+
+    //! Buffers of affine coefficients.
+    Eigen::RowVectorXcd C, D;
+public:
+    /**
+     * @brief           A model constructor
+     *
+     * @details         If v_0 is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   params  Heston model parameteres struct
+     * @param   v_0     Initial volatility value
+     */
+    HestonModel(const HestonParams &params, double v_0);
+
+    /**
+     * @brief           Calculate logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$
+     *
+     * @param   u       Grid of complex arguments of char. function
+     * @param   T       Time to maturity
+     * @param   result  Output vector of u shape
+     */
+    void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result);
+
+    /**
+     * @brief           Get critical moments of \f$ \frac{F_T}{F} \f$
+     *
+     * @see             heston_critical_moments
+     */
+    std::pair<double, double> moment_strip(double T);
+
+    /**
+     * @brief           Heston model parameteres setter
+     */
+    void set_params(const HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres
+     */
+    HestonParams get_params();
+
+    /**
+     * @brief           Initial volatility value setter
+     *
+     * @details         If v_0 is non-positive, std::invalid_argument is thrown.
+     */
+    void set_v0(double v_0);
+
+    /**
+     * @brief           Get initial volatility value
+     */
+    double get_v0();
+};
+
+/**
+ * @brief       SVJJ (Bates) model policy of FourierPricer
+ *
+ * @details     Log char. function is \f$ C(u,T) + J(u,T) + D(u,T)v_0 \f$ of heston_cf_coefficients() and
+ *              svjj_jump_coefficient(), moment strip is of svjj_critical_moments(). Jump price transform is
+ *              cached for the last grid of arguments, so pricing of several maturities on the same grid
+ *              calculates it once. See HestonModel for the policy interface.
+ *              Parameteres must be positive, jumps parameteres are checked by check_jump_params().
+ */
+class SvjjModel {
+private:
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Jumps parameteres struct.
+    JumpParams jumps;
+
+    //! Initial volatility value.
+    double v_0;
+
+    //! Grid of arguments of cached jump price transform.
+    Eigen::RowVectorXcd transform_grid;
+
+    //! Jump price transform at transform_grid.
+    Eigen::RowVectorXcd transform;
+
+    //! Buffers of affine and jumps coefficients.
+    Eigen::RowVectorXcd C, D, J;
+public:
+    /**
+     * @brief           A model constructor
+     *
+     * @details         If v_0 is non-positive or jumps are invalid, std::invalid_argument is thrown.
+     *
+     * @param   params  Heston model parameteres struct
+     * @param   jumps   Jumps parameteres struct
+     * @param   v_0     Initial volatility value
+     */
+    SvjjModel(const HestonParams &params, const JumpParams &jumps, double v_0);
+
+    /**
+     * @brief           Calculate logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$
+     *
+     * @param   u       Grid of complex arguments of char. function
+     * @param   T       Time to maturity
+     * @param   result  Output vector of u shape
+     */
+    void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result);
+
+    /**
+     * @brief           Get critical moments of \f$ \frac{F_T}{F} \f$
+     *
+     * @see             svjj_critical_moments
+     */
+    std::pair<double, double> moment_strip(double T);
+
+    /**
+     * @brief           Heston model parameteres setter
+     */
+    void set_params(const HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres
+     */
+    HestonParams get_params();
+
+    /**
+     * @brief           Jumps parameteres setter
+     *
+     * @details         If jumps are invalid, std::invalid_argument is thrown (see check_jump_params()).
+     */
+    void set_jumps(const JumpParams &jumps);
+
+    /**
+     * @brief           Get jumps parameteres
+     */
+    JumpParams get_jumps();
+
+    /**
+     * @brief           Initial volatility value setter
+     *
+     * @details         If v_0 is non-positive, std::invalid_argument is thrown.
+     */
+    void set_v0(double v_0);
+
+    /**
+     * @brief           Get initial volatility value
+     */
+    double get_v0();
+};
+
 #endif  // HESTON_MODEL_H
\ No newline at end of file
@@ -6,15 +6,82 @@
 #define HESTON_PRICING_H
 
 #include <utility>
+#include <chrono>
+#include <tuple>
+#include <limits>
 
 #include "fft.h"
+#include "carr_madan.h"
+#include "nufft.h"
+#include "interpolation.h"
+#include "lru_cache.h"
+#include "black_scholes.h"
 #include "heston_model.h"
 #include "european_options.h"
 
+//! Methods of prices evaluation at arbitrary strikes.
+enum StrikesEvaluation
+{
+    //! Cubic spline interpolation of prices on log strikes grid.
+    SPLINE_EVALUATION,
+
+    //! Non-uniform FFT directly at given strikes.
+    NUFFT_EVALUATION,
+
+    //! Direct summation of the Carr-Madan sum at given strikes.
+    DIRECT_EVALUATION
+};
+
+//! Methods of prices evaluation at far out-of-the-money strikes.
+enum WingsEvaluation
+{
+    //! Lugannani-Rice saddlepoint approximation with moment formula tails, constant cost per strike.
+    SADDLEPOINT_WINGS,
+
+    //! Damped single-strike quadrature through the saddlepoint, accurate to rounding.
+    QUADRATURE_WINGS
+};
+
+/**
+ * @brief       European option prices and their sensitivities on log strikes grid
+ *
+ * @details     Every element is a vector of shape N, one value per log strike of the grid.
+ */
+struct EuropeanOptionGreeks
+{
+    //! Option prices
+    Eigen::RowVectorXd price;
+
+    //! Derivative w.r.t. initial stock price
+    Eigen::RowVectorXd delta;
+
+    //! Second derivative w.r.t. initial stock price
+    Eigen::RowVectorXd gamma;
+
+    //! Derivative w.r.t. initial volatility value
+    Eigen::RowVectorXd vega;
+
+    //! Minus derivative w.r.t. time to maturity
+    Eigen::RowVectorXd theta;
+
+    //! Derivative w.r.t. risk-free interest rate
+    Eigen::RowVectorXd rho;
+
+    //! Second derivative w.r.t. initial stock price and volatility value (empty if not calculated)
+    Eigen::RowVectorXd vanna;
+
+    //! Second derivative w.r.t. initial volatility value (empty if not calculated)
+    Eigen::RowVectorXd volga;
+
+    //! Minus derivative of delta w.r.t. time to maturity (empty if not calculated)
+    Eigen::RowVectorXd charm;
+};
+
 /**
  * @brief               A class of Heston model european options calculator
  * 
  * @details             It encapsulates model and market parameteres, aswell as it's own.
+ *                      Jumps of SVJJ (Bates) model are set by set_jumps(), without them it is Heston model.
  *                      Integral discretization elements count must be even.
  *                      Other parameteres must be positive.
  */
@@ -44,6 +111,33 @@ private:
     //! Log strike grid step \f$\Delta k>0\f$.
     double d_k;
 
+    //! Method of prices evaluation at arbitrary strikes.
+    StrikesEvaluation strikes_evaluation;
+
+    //! Bins count from which FFT is cheaper than direct summation (non-positive if not measured).
+    int direct_threshold;
+
+    //! Moneyness beyond which calculate_at() prices strikes by calculate_wings() (infinite if disabled).
+    double wing_moneyness;
+
+    //! Method of prices evaluation at far out-of-the-money strikes.
+    WingsEvaluation wings_evaluation;
+
+    //! Affine coefficients \f$ C(w,T), D(w,T) \f$ at \f$ w_n = u_n - (\alpha+1)i \f$ of recently priced maturities.
+    LruCache<double, std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd> > coefficients_cache;
+
+    //! Normalised call prices splines (\f$ s_0 = 1 \f$, log-moneyness axis) keyed by \f$ (\rho,\kappa,\theta,\sigma,v_0,T) \f$.
+    LruCache<std::tuple<double, double, double, double, double, double>, UniformCubicSpline> surfaces_cache;
+
+    //! Jumps parameteres struct (no jumps by default).
+    JumpParams jumps;
+
+    //! Jump price transform at \f$ w_n = u_n - (\alpha+1)i \f$, calculated once per grid (only for nonzero intensity).
+    Eigen::RowVectorXcd jump_transform;
+
+    //! Trapezoid rule weights divided by Carr-Madan denominator on u grid, see carr_madan_weights().
+    Eigen::RowVectorXcd integrand_weights;
+
     /**
      * @brief           Calculate discount factor \f$ B(t,T)e^{-r(T-t)} \f$.
      * 
@@ -51,6 +145,233 @@ private:
      * @param   T       Terminal time value
      */
     double df(double t, double T);  // get discount factor
+
+    /**
+     * @brief           Get affine coefficients of char. function on u grid
+     *
+     * @details         Coefficients \f$ C(w_n,T), D(w_n,T) \f$ depend on Heston parameters and grid only,
+     *                  so they are calculated by heston_cf_coefficients once per maturity and cached.
+     *                  Jumps part of svjj_jump_coefficient() is added to C.
+     *                  Cache keeps get_cache_capacity() least recently used maturities, it is cleared by
+     *                  set_params(), set_jumps() and set_calculator_params().
+     *
+     * @param   T       Time to maturity
+     *
+     * @return          pair of C and D vectors of shape N.
+     */
+    const std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd> &affine_coefficients(double T);
+
+    /**
+     * @brief           Calculate integrand of Carr-Madan formula on u grid
+     *
+     * @details         Calculates \f$ \psi(u_n) \f$ as heston_exp_option_cf does for \f$ u_n = n\Delta u \f$,
+     *                  i.e. \f$ e^{C + Dv_0 + iw_nx} \f$ from cached coefficients times integrand weights,
+     *                  so a change of spot or initial volatility costs one complex exponent per node.
+     *                  First value is halved as trapezoid rule weight.
+     *                  If Andersen-Piterbarg condition is false, std::invalid_argument is thrown.
+     *
+     * @param   T       Time to maturity
+     */
+    Eigen::RowVectorXcd integrand(double T);
+
+    /**
+     * @brief           Calculate integrand of Carr-Madan formula on u grid for given spot
+     *
+     * @see             integrand(double T)
+     */
+    Eigen::RowVectorXcd integrand(double T, double spot);
+
+    /**
+     * @brief           Get normalised call prices surface of given maturity
+     *
+     * @details         Call prices are homogeneous in \f$ (S, K) \f$: \f$ C(S, K) = S\,c(\ln\frac{K}{S}) \f$,
+     *                  where c is the price for \f$ s_0 = 1 \f$. Prices c on log strike grid are calculated
+     *                  by FFT once per \f$ (\rho,\kappa,\theta,\sigma,v_0,T) \f$ and cached as a cubic spline,
+     *                  get_cache_capacity() least recently used surfaces are kept.
+     *                  If Andersen-Piterbarg condition is false, std::invalid_argument is thrown.
+     *
+     * @param   T       Time to maturity
+     */
+    UniformCubicSpline &normalised_surface(double T);
+
+    /**
+     * @brief           Calculate option prices from transformed integrand
+     *
+     * @details         Calculates \f$ \frac{B(0,T)\Delta u}{\pi}e^{-\alpha k}\mathrm{Re}\sum_n\psi(u_n)e^{-iu_nk} \f$
+     *                  by given sums, for put type Call-Put Parity is used (see carr_madan_prices()).
+     *
+     * @param   option      European option with given time to maturity and type
+     * @param   log_strikes Log strikes of the sums
+     * @param   transform   Sums \f$ \sum_n\psi(u_n)e^{-iu_nk} \f$ for every log strike
+     */
+    Eigen::RowVectorXd prices_from_transform(
+        EuropeanOption &option,
+        const Eigen::RowVectorXd &log_strikes,
+        const Eigen::RowVectorXcd &transform
+    );
+
+    /**
+     * @brief           Calculate derivative of log char. function w.r.t. time to maturity on u grid
+     *
+     * @details         At fixed x it is given by Riccati equations:
+     *                  \f$ \kappa\theta D + v_0\left(\frac{(iw)^2-iw}{2} - (\kappa-\rho\sigma iw)D + \frac{\sigma^2}{2}D^2\right) \f$
+     *                  with cached coefficient \f$ D(w_n,T) \f$.
+     *
+     * @param   T       Time to maturity
+     */
+    Eigen::RowVectorXcd maturity_log_cf_derivative(double T);
+
+    /**
+     * @brief           Calculate call prices and their log strike derivatives on inner strikes grid
+     *
+     * @details         Derivative w.r.t. k of \f$ e^{-\alpha k}e^{-iuk} \f$ is \f$ (-\alpha-iu) \f$ times itself,
+     *                  so \f$ \partial_k C \f$ and \f$ \partial_k^2 C \f$ are transforms of the integrand multiplied
+     *                  by \f$ (-\alpha-iu) \f$ and \f$ (-\alpha-iu)^2 \f$. All integrands are transformed by one batched
+     *                  fft() call. Optionally \f$ \partial_T C \f$ at fixed strike is added by
+     *                  maturity_log_cf_derivative(), \f$ \partial_x \f$ multiplier \f$ iw = 1-(-\alpha-iu) \f$
+     *                  and discounting.
+     *                  If Andersen-Piterbarg condition is false, std::invalid_argument is thrown.
+     *
+     * @param   T                   Time to maturity
+     * @param   maturity_derivative Whether \f$ \partial_T C \f$ is calculated
+     *
+     * @return          array of rows \f$ C, \partial_k C, \partial_k^2 C \f$ (and \f$ \partial_T C \f$) of shape N.
+     */
+    Eigen::ArrayXXd log_strike_derivatives(double T, bool maturity_derivative);
+
+    /**
+     * @brief           Calculate european option prices at given strikes by current strikes evaluation method
+     *
+     * @see             calculate_at()
+     */
+    Eigen::RowVectorXd evaluate_at(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Calculate logarithm of moments of forward price ratio at complex exponents
+     *
+     * @details         \f$ \ln\mathbb{E}(F_T/F)^{z+1} = C + Dv_0 \f$ is evaluated by one heston_cf_coefficients()
+     *                  call at \f$ u = -i(z+1) \f$, jump coefficient is added for nonzero jump intensity.
+     *
+     * @param   T       Time to maturity
+     * @param   z       Vector of complex damping exponents
+     *
+     * @return          vector of logarithms of moments of z shape.
+     */
+    Eigen::RowVectorXcd log_moment(double T, const Eigen::RowVectorXcd &z);
+
+    /**
+     * @brief           Calculate cumulant generating function of damped price and its derivatives
+     *
+     * @details         Undiscounted price per forward \f$ c(y) \f$ of out-of-the-money option at log-moneyness
+     *                  \f$ y = \ln\frac{K}{F} \f$ damped by \f$ e^{ay} \f$ has Laplace transform
+     *                  \f$ \int e^{ay}c(y)dy = \frac{\mathbb{E}(F_T/F)^{a+1}}{a(a+1)} \f$ for calls (\f$ a>0 \f$) and
+     *                  puts (\f$ a<-1 \f$). Its logarithm \f$ \Lambda(a) = C + Dv_0 - \ln(a(a+1)) \f$ is evaluated
+     *                  at points \f$ a + \rho e^{i\theta_m} \f$ of a circle by one heston_cf_coefficients() call
+     *                  at \f$ u = -i(a+1) \f$, and derivatives are Cauchy integrals summed by trapezoid rule.
+     *                  Dropping one pole gives cumulant generating function of a probability density:
+     *                  \f$ \Lambda(a) + \ln a = \ln\mathbb{E}(F_T/F)^{a+1} - \ln(a+1) \f$ of \f$ e^y\mathbb{Q}(Y>y) \f$
+     *                  for calls and \f$ \Lambda(a) + \ln(-a-1) \f$ of put tail for puts, see lugannani_rice_price().
+     *
+     * @param   T           Time to maturity
+     * @param   a           Damping exponent
+     * @param   radius      Circle radius, less than distance to kept poles and critical moments
+     * @param   zero_pole   Whether \f$ \ln|a| \f$ is subtracted
+     * @param   unit_pole   Whether \f$ \ln|a+1| \f$ is subtracted
+     *
+     * @return          vector of \f$ \Lambda \f$ and its first four derivatives at a.
+     */
+    Eigen::VectorXd damped_cgf(double T, double a, double radius, bool zero_pole = true, bool unit_pole = true);
+
+    /**
+     * @brief           Find saddlepoint of damped out-of-the-money price
+     *
+     * @details         Saddlepoint \f$ \Lambda'(\hat a) = y \f$ is found by safeguarded Newton iterations
+     *                  inside of \f$ (a_-, a_+) \f$, where \f$ e^{\Lambda(a) - ay} \f$ is minimal along the real axis.
+     *                  Iterations start from the guess if it lies inside of the interval.
+     *
+     * @param   T       Time to maturity
+     * @param   y       Log-moneyness \f$ \ln\frac{K}{F} \f$
+     * @param   lower   Lower bound \f$ a_- \f$ of damping exponent
+     * @param   upper   Upper bound \f$ a_+ \f$ of damping exponent (may be infinite)
+     * @param   cgf     Output vector of damped_cgf() at saddlepoint
+     * @param   zero_pole   Whether \f$ \ln|a| \f$ is subtracted from \f$ \Lambda \f$, see damped_cgf()
+     * @param   unit_pole   Whether \f$ \ln|a+1| \f$ is subtracted from \f$ \Lambda \f$, see damped_cgf()
+     * @param   guess       Initial damping exponent (NaN for the middle of the interval)
+     *
+     * @return          saddlepoint \f$ \hat a \f$.
+     */
+    double saddlepoint_exponent(
+        double T,
+        double y,
+        double lower,
+        double upper,
+        Eigen::VectorXd &cgf,
+        bool zero_pole = true,
+        bool unit_pole = true,
+        double guess = std::numeric_limits<double>::quiet_NaN()
+    );
+
+    /**
+     * @brief           Calculate undiscounted out-of-the-money price per forward by damped single-strike quadrature
+     *
+     * @details         Price is inverted along the line \f$ z = a + iu \f$ of the damping strip:
+     *                  \f$ c(y) = \frac{1}{\pi}\int_0^\infty \mathrm{Re}\frac{e^{-zy}\mathbb{E}(F_T/F)^{z+1}}{z(z+1)}du \f$
+     *                  by trapezoid rule. Step is \f$ 0.5/\max(\sqrt{\Lambda''}, |y - \Lambda'|) \f$, but at most
+     *                  0.15 of distance to strip bounds, so discretisation error is below \f$ e^{-2\pi/0.15} \f$;
+     *                  sum is truncated once the integrand drops below \f$ 10^{-17} \f$ of its value at \f$ u = 0 \f$.
+     *                  At saddlepoint the integrand does not oscillate and its magnitude is of the price,
+     *                  so the error is relative to the price.
+     *
+     * @param   T       Time to maturity
+     * @param   y       Log-moneyness \f$ \ln\frac{K}{F} \f$
+     * @param   a       Damping exponent
+     * @param   lower   Lower bound \f$ a_- \f$ of damping exponent
+     * @param   upper   Upper bound \f$ a_+ \f$ of damping exponent (may be infinite)
+     * @param   cgf     Vector of damped_cgf() at a
+     */
+    double damped_price(double T, double y, double a, double lower, double upper, const Eigen::VectorXd &cgf);
+
+    /**
+     * @brief           Calculate undiscounted out-of-the-money price per forward by Lugannani-Rice formula
+     *
+     * @details         Call price \f$ c(y) = \int_y^\infty e^x\mathbb{Q}(X>x)dx \f$ is a tail probability of density
+     *                  with cumulant generating function \f$ K(s) = \ln\mathbb{E}(F_T/F)^{s+1} - \ln(s+1) \f$,
+     *                  put price is \f$ e^y \f$ times the tail at \f$ -y \f$ of \f$ K(s) = \ln\mathbb{E}(F_T/F)^{-s}
+     *                  - \ln(s+1) \f$ (share measure). The tail is
+     *                  \f$ 1 - N(w) + \varphi(w)\left(\frac{1}{u} - \frac{1}{w} + \frac{1}{u}\left(\frac{\lambda_4}{8}
+     *                  - \frac{5\lambda_3^2}{24}\right) - \frac{\lambda_3}{2u^2} - \frac{1}{u^3} + \frac{1}{w^3}\right) \f$
+     *                  with \f$ w = \mathrm{sgn}(\hat s)\sqrt{2(\hat sy - K(\hat s))} \f$, \f$ u = \hat s\sqrt{K''} \f$
+     *                  and standardised cumulants \f$ \lambda_3, \lambda_4 \f$, so the error is relative to the price.
+     *                  Next to the mean (\f$ |w| < 10^{-3} \f$) the limit \f$ \frac{1}{2} - \frac{\lambda_3}{6\sqrt{2\pi}} \f$
+     *                  is used.
+     *
+     * @param   y       Log-moneyness \f$ \ln\frac{K}{F} \f$
+     * @param   a       Damping exponent of saddlepoint, \f$ \hat s = a \f$ for calls and \f$ -a-1 \f$ for puts
+     * @param   is_call Whether call (\f$ y>0 \f$) or put is priced
+     * @param   cgf     Vector of damped_cgf() at a without zero pole for calls and without unit pole for puts
+     */
+    double lugannani_rice_price(double y, double a, bool is_call, const Eigen::VectorXd &cgf);
+
+    /**
+     * @brief           Calculate Carr-Madan integrand and its derivatives w.r.t. Heston parameters on u grid
+     *
+     * @details         Char. function and gradient of its logarithm share coefficients, see heston_cf_gradient.
+     *                  Jumps part is held fixed: dependence of variance jumps part on Heston parameteres
+     *                  is not differentiated (Bates jumps part does not depend on them).
+     *                  First values are halved as in integrand().
+     *                  If Andersen-Piterbarg condition is false, std::invalid_argument is thrown.
+     *
+     * @param   T       Time to maturity
+     *
+     * @return          matrix of 6 rows: \f$ \psi \f$ and \f$ \psi\,\partial_p\ln\varphi \f$ for
+     *                  \f$ p = v_0, \rho, \kappa, \theta, \sigma \f$.
+     */
+    Eigen::MatrixXcd jacobian_integrands(double T);
+
+    /**
+     * @brief           Check whether all log strikes lie inside the log strike grid
+     */
+    bool inside_grid(const Eigen::RowVectorXd &log_strikes);
 public:
     /**
      * @brief           A calculator constructor
@@ -83,6 +404,70 @@ public:
      */
     void set_calculator_params(double alpha, int N, double d_u);
 
+    /**
+     * @brief           Initial stock price setter
+     *
+     * @details         If s_0 is non-positive, std::invalid_argument is thrown.
+     *                  Cached char. function coefficients stay valid.
+     */
+    void set_spot(double s_0);
+
+    /**
+     * @brief           Get initial stock price
+     */
+    double get_spot();
+
+    /**
+     * @brief           Initial volatility value setter
+     *
+     * @details         If v_0 is non-positive, std::invalid_argument is thrown.
+     *                  Cached char. function coefficients stay valid.
+     */
+    void set_v0(double v_0);
+
+    /**
+     * @brief           Get initial volatility value
+     */
+    double get_v0();
+
+    /**
+     * @brief           Heston model parameteres setter
+     *
+     * @details         Cached char. function coefficients are cleared.
+     */
+    void set_params(HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres
+     */
+    HestonParams get_params();
+
+    /**
+     * @brief           Jumps parameteres setter
+     *
+     * @details         Cached char. function coefficients and surfaces are cleared.
+     *                  If jumps are invalid, std::invalid_argument is thrown (see check_jump_params()).
+     */
+    void set_jumps(const JumpParams &jumps);
+
+    /**
+     * @brief           Jumps parameteres setter with precalculated jump price transform
+     *
+     * @details         The same as set_jumps(), but jump_price_transform() at \f$ w_n = u_n - (\alpha+1)i \f$
+     *                  of the calculator grid is given (e.g. shared by calculators of the same grid), so it is not
+     *                  recalculated. Transform is ignored for zero intensity. If its size is not N,
+     *                  std::invalid_argument is thrown.
+     *
+     * @param   jumps       Jumps parameteres struct
+     * @param   transform   Vector of jump price transform on the grid
+     */
+    void set_jumps(const JumpParams &jumps, const Eigen::RowVectorXcd &transform);
+
+    /**
+     * @brief           Get jumps parameteres
+     */
+    JumpParams get_jumps();
+
     /**
      * @brief           Get exponent Carr-Madan parameter value
      */
@@ -114,6 +499,7 @@ public:
      * @brief           Check condition of finite moments
      * 
      * @details         Checks Andersen Piterbarg condition (\f$\mathbb{E}S_T^{\alpha+1} < \infty\f$).
+     *                  Variance jumps may explode the moment earlier, then the flag is false (see svjj_moment_finite()).
      *                  If \f$ T^*=0 \f$ is returned, that means T*=+infty.
      *                  If \f$ T^*\neq0\f$ consider checking the returned flag.
      * 
@@ -140,6 +526,283 @@ public:
      * @see             Project's overleaf page at Main Page
      */
     Eigen::RowVectorXd calculate(EuropeanOption &option);
+
+    /**
+     * @brief           Calculate european option prices and their strike derivatives at inner strikes grid
+     *
+     * @details         Derivatives are closed-form multipliers of Carr-Madan integrand, see log_strike_derivatives(),
+     *                  so no finite differences are involved:
+     *                  \f$ \partial_K C = \frac{1}{K}\partial_k C \f$, \f$ \partial_K^2 C = \frac{1}{K^2}(\partial_k^2 C - \partial_k C) \f$.
+     *                  Risk-neutral density of \f$ S_T \f$ at strike K is \f$ e^{rT}\partial_K^2 C \f$ and its
+     *                  distribution function is \f$ 1 + e^{rT}\partial_K C \f$ (digital call price is \f$ -\partial_K C \f$).
+     *                  For put type Call-Put Parity is used: \f$ \partial_K P = \partial_K C + B(0,T) \f$.
+     *
+     * @param   option      European option with given time to maturity and type
+     * @param   d_strike    Output vector of first derivatives w.r.t. strike of shape N
+     * @param   d_strike2   Output vector of second derivatives w.r.t. strike of shape N
+     *
+     * @return          vector of prices of shape N.
+     */
+    Eigen::RowVectorXd calculate(
+        EuropeanOption &option,
+        Eigen::RowVectorXd &d_strike,
+        Eigen::RowVectorXd &d_strike2
+    );
+
+    /**
+     * @brief           Calculate Dupire local volatility surface on inner strikes grid
+     *
+     * @details         Local variance is \f$ \sigma^2(K,T) = \frac{\partial_T C + rK\partial_K C}{\frac{1}{2}K^2\partial_K^2 C} \f$,
+     *                  all derivatives are taken analytically in Fourier space, see log_strike_derivatives(),
+     *                  one batched fft() call per maturity. In log strike: numerator is \f$ \partial_T C + r\partial_k C \f$,
+     *                  denominator is \f$ \frac{1}{2}(\partial_k^2 C - \partial_k C) \f$.
+     *                  Where density or numerator is not positive (far wings, where transform noise dominates)
+     *                  NaN is returned.
+     *                  If any maturity is non-positive or Andersen-Piterbarg condition is false,
+     *                  std::invalid_argument is thrown.
+     *
+     * @param   maturities  Vector of times to maturity
+     *
+     * @return          matrix of local volatilities of shape (maturities count) x N, columns follow get_log_strike_grid().
+     */
+    Eigen::MatrixXd calculate_local_volatility(const Eigen::RowVectorXd &maturities);
+
+    /**
+     * @brief           Calculate european option prices at given nodes of inner strikes grid
+     *
+     * @details         Prices are the same as calculate() returns at given indices of get_log_strike_grid().
+     *                  If bins count is below get_direct_threshold(), DFT bins are summed directly by goertzel(),
+     *                  otherwise full FFT is calculated and requested bins are picked.
+     *                  If any index is out of [0, N), std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   bins    Vector of indices of log strikes grid
+     *
+     * @return          vector of prices of bins shape.
+     */
+    Eigen::RowVectorXd calculate(EuropeanOption &option, const Eigen::RowVectorXi &bins);
+
+    /**
+     * @brief           Measure bins count from which FFT is cheaper than direct summation
+     *
+     * @details         Times fft() and goertzel() for one bin on vectors of size N, threshold is their ratio.
+     *                  Char. function evaluation is shared by both methods, so it is not timed.
+     *                  Threshold is remembered until grid parameteres are changed.
+     *
+     * @return          measured threshold.
+     */
+    int benchmark_direct_threshold();
+
+    /**
+     * @brief           Get bins count from which FFT is cheaper than direct summation
+     *
+     * @details         If threshold is not measured yet for current N, benchmark_direct_threshold() is called.
+     */
+    int get_direct_threshold();
+
+    /**
+     * @brief           Calculate european option prices at given strikes by FFT
+     *
+     * @details         Evaluation depends on strikes evaluation method:
+     *                      1) SPLINE_EVALUATION: prices are calculated on inner strikes grid by calculate(), then
+     *                         natural cubic spline in log strike is built once over the uniform grid and evaluated
+     *                         at all strikes in one pass; interpolation error grows with price curvature
+     *                         at short maturities, e.g. about \f$ 2\cdot10^{-5}s_0 \f$ at T = 0.05 and
+     *                         \f$ 10^{-6}s_0 \f$ at T = 1 with N = 4096, \f$ \Delta u = 0.05 \f$, orders of magnitude
+     *                         above the error of other methods,
+     *                      2) NUFFT_EVALUATION: the same integrand is summed exactly at given strikes by nufft(),
+     *                         hence no interpolation error is introduced,
+     *                      3) DIRECT_EVALUATION: the same integrand is summed at given strikes by goertzel(),
+     *                         which costs N operations per strike, but is cheapest for a few strikes.
+     *                  Strikes beyond wing moneyness are priced by calculate_wings(), see set_wing_moneyness().
+     *                  If any strike is non-positive or (except for DIRECT_EVALUATION and wing strikes) lies outside
+     *                  of the log strike grid, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     *
+     * @return          vector of prices of strikes shape.
+     */
+    Eigen::RowVectorXd calculate_at(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Calculate european option prices at given strikes by cached normalised surface
+     *
+     * @details         Prices are \f$ s_0\,c(\ln\frac{K}{s_0}) \f$ of the spline of normalised call prices,
+     *                  put prices are given by Call-Put Parity. Surface is calculated at first request of
+     *                  given parameters, initial volatility and maturity, so spot changes cost only
+     *                  interpolation at strikes. Accuracy is that of SPLINE_EVALUATION (e.g. about
+     *                  \f$ 2\cdot10^{-5}s_0 \f$ at T = 0.05), far below NUFFT_EVALUATION and DIRECT_EVALUATION.
+     *                  If any strike is non-positive or log-moneyness \f$ \ln\frac{K}{s_0} \f$ lies outside
+     *                  of the log strike grid, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     *
+     * @return          vector of prices of strikes shape.
+     */
+    Eigen::RowVectorXd calculate_from_surface(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Clear cached char. function coefficients and normalised surfaces
+     */
+    void clear_cache();
+
+    /**
+     * @brief           Cache capacity setter
+     *
+     * @details         At most capacity maturities of char. function coefficients and capacity normalised
+     *                  surfaces are cached (LRU_CACHE_CAPACITY by default), the least recently used ones are evicted.
+     *                  If capacity is non-positive, std::invalid_argument is thrown.
+     */
+    void set_cache_capacity(int capacity);
+
+    /**
+     * @brief           Get cache capacity
+     */
+    int get_cache_capacity();
+
+    /**
+     * @brief           Calculate european option prices at far out-of-the-money strikes
+     *
+     * @details         Absolute error floor of FFT swamps tiny wing prices, so each strike is priced through
+     *                  the saddlepoint of its damping exponent (see saddlepoint_exponent()), where the error is
+     *                  relative to the price. Out-of-the-money side is priced (calls for \f$ K>F \f$, puts for
+     *                  \f$ K\leq F \f$), other option type is given by Call-Put Parity. Exponents are bounded by
+     *                  critical moments \f$ \omega_\pm \f$ (see heston_critical_moments()), which saddlepoint
+     *                  approaches as strike goes to extremes. Newton iterations start from the saddlepoint
+     *                  of the previous strike of the same side, so sorted strikes are cheaper.
+     *
+     *                  SADDLEPOINT_WINGS (default) applies lugannani_rice_price(), about 3 damped_cgf() calls
+     *                  (15-25 us) per strike, so 50 wing strikes cost about one FFT of \f$ N = 4096 \f$.
+     *                  Beyond 0.1% of the exponent interval next to a critical moment total implied variance
+     *                  of the last saddlepoint strike is extrapolated linearly with Lee moment formula slope
+     *                  \f$ 2 - 4(\sqrt{p^2+p} - p) \f$, \f$ p = \omega_+ - 1 \f$ or \f$ -\omega_- \f$ (Benaim-Friz
+     *                  limit of Heston smile). The slope is only reached asymptotically, so the cutoff is
+     *                  far enough that it matters only for long maturities (within a factor of 3 of the exact
+     *                  price for \f$ \sigma = 1, T = 30 \f$), where the edge price does not underflow.
+     *                  For \f$ v_0 = 0.04, \rho = -0.7, \kappa = 1.5, \theta = 0.04, \sigma = 0.5 \f$ and
+     *                  \f$ 1 \leq |\ln\frac{K}{F}| \leq 15 \f$ measured relative error is below \f$ 2\cdot10^{-4} \f$
+     *                  for \f$ T = 0.1 \f$, \f$ 2\cdot10^{-3} \f$ for \f$ T = 0.5 \f$, \f$ 5\cdot10^{-3} \f$ for
+     *                  \f$ T = 1 \f$ and 6% for \f$ T = 3..10 \f$, decreasing further out. Near the money and
+     *                  where a critical moment is close to 0 or 1 (e.g. \f$ \sigma = 1, T \geq 5 \f$) error
+     *                  grows to tens of percent.
+     *
+     *                  QUADRATURE_WINGS applies damped_price() along the line through the saddlepoint, beyond
+     *                  2% of the strip next to a critical moment the line is kept there, which still gives
+     *                  the exact price. Cost is about 0.1-0.8 ms per strike (a few hundred char. function
+     *                  values). For the parameters above and \f$ T = 0.1..3 \f$ measured relative error is below
+     *                  \f$ 10^{-9} \f$ for \f$ |\ln\frac{K}{F}| \leq 15 \f$ (prices down to \f$ 10^{-270} \f$) and
+     *                  agreement with FFT of \f$ N = 4096 \f$ is within its absolute error floor of
+     *                  \f$ 10^{-16} \f$; accuracy is lost only where prices underflow double precision.
+     *                  If any strike is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     *
+     * @return          vector of prices of strikes shape.
+     */
+    Eigen::RowVectorXd calculate_wings(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Wing moneyness setter
+     *
+     * @details         calculate_at() prices strikes with \f$ \max(\frac{K}{F}, \frac{F}{K}) \f$ above
+     *                  moneyness by calculate_wings(), such strikes may lie outside of the log strike grid.
+     *                  Wing prices keep relative accuracy below the FFT error floor, see calculate_wings() for
+     *                  accuracy and cost of set_wings_evaluation() methods.
+     *                  Infinite moneyness (default) disables wings. If moneyness is not greater than 1,
+     *                  std::invalid_argument is thrown.
+     */
+    void set_wing_moneyness(double moneyness);
+
+    /**
+     * @brief           Get wing moneyness
+     */
+    double get_wing_moneyness();
+
+    /**
+     * @brief           Set method of prices evaluation at far out-of-the-money strikes used by calculate_wings()
+     */
+    void set_wings_evaluation(WingsEvaluation evaluation);
+
+    /**
+     * @brief           Get method of prices evaluation at far out-of-the-money strikes
+     */
+    WingsEvaluation get_wings_evaluation();
+
+    /**
+     * @brief           Set method of prices evaluation at arbitrary strikes used by calculate_at()
+     */
+    void set_strikes_evaluation(StrikesEvaluation evaluation);
+
+    /**
+     * @brief           Get method of prices evaluation at arbitrary strikes
+     */
+    StrikesEvaluation get_strikes_evaluation();
+
+    /**
+     * @brief           Calculate european option prices and first order Greeks at inner strikes grid
+     *
+     * @details         Every Greek is a closed-form multiplier of Carr-Madan integrand \f$ \psi(u) \f$ in Fourier space,
+     *                  where char. function is \f$ \varphi(w) = e^{C + Dv + iwx},~ w = u - (\alpha+1)i \f$:
+     *                      1) \f$ \partial_x \f$ is \f$ iw \f$, \f$ \partial_x^2 \f$ is \f$ (iw)^2 \f$, delta and gamma
+     *                         follow by \f$ x = \ln s_0 + rT \f$,
+     *                      2) \f$ \partial_v \f$ is \f$ D(w,T) \f$,
+     *                      3) \f$ \partial_T \f$ at fixed x is given by Riccati equations
+     *                         \f$ \kappa\theta D + v\left(-\frac{w^2+iw}{2} - (\kappa-\rho\sigma iw)D + \frac{\sigma^2}{2}D^2\right) \f$,
+     *                      4) rho is \f$ T(\partial_x C - C) \f$.
+     *                  Second order Greeks are products of the same multipliers: vanna is \f$ iwD/s_0 \f$,
+     *                  volga is \f$ D^2 \f$ and charm is obtained from \f$ iw\partial_T\ln\varphi \f$.
+     *                  Prices and all multiplied integrands are transformed by one batched fft() call,
+     *                  which replaces about 10 bumped calculate() calls. For put type Call-Put Parity is used.
+     *
+     * @param   option          European option with given time to maturity and type
+     * @param   second_order    Whether vanna, volga and charm are calculated
+     *
+     * @return          prices and Greeks of shape N.
+     *
+     * @see             Project's overleaf page at Main Page
+     */
+    EuropeanOptionGreeks calculate_with_greeks(EuropeanOption &option, bool second_order = false);
+
+    /**
+     * @brief           Calculate Jacobian of prices at inner strikes grid w.r.t. Heston parameters
+     *
+     * @details         Derivative of Carr-Madan integrand w.r.t. parameter p is \f$ \psi\,\partial_p\ln\varphi \f$,
+     *                  gradient of log char. function is calculated by heston_cf_gradient, which shares
+     *                  intermediates with char. function itself. All five integrands are transformed by one
+     *                  batched fft() call. Jacobian is the same for call and put types.
+     *                  If Andersen-Piterbarg condition is false, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity
+     *
+     * @return          matrix of shape N x 5 of derivatives w.r.t. \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$.
+     *
+     * @see             Project's overleaf page at Main Page
+     */
+    Eigen::MatrixXd calculate_jacobian(EuropeanOption &option);
+
+    /**
+     * @brief           Calculate european option prices and their Jacobian w.r.t. Heston parameters at given strikes
+     *
+     * @details         Prices and Jacobian integrands (see calculate_jacobian()) are evaluated at strikes
+     *                  by the same strikes evaluation method as calculate_at() uses, so calibration to quotes
+     *                  needs one call per maturity. For put type Call-Put Parity is used for prices.
+     *                  If any strike is non-positive or (except for DIRECT_EVALUATION) lies outside
+     *                  of the log strike grid, std::invalid_argument is thrown.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     * @param   prices  Output vector of prices of strikes shape
+     *
+     * @return          matrix of shape (strikes count) x 5 of derivatives w.r.t. \f$ (v_0, \rho, \kappa, \theta, \sigma) \f$.
+     */
+    Eigen::MatrixXd calculate_jacobian_at(
+        EuropeanOption &option,
+        const Eigen::RowVectorXd &strikes,
+        Eigen::RowVectorXd &prices
+    );
 };
 
 #endif  // HESTON_PRICING_H
\ No newline at end of file
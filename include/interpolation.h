@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @brief Interpolation on uniform grids.
+ */
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Dense>
+
+/**
+ * @brief       A natural cubic spline on uniform grid
+ *
+ * @details     Spline is built once in \f$ \mathcal{O}(n) \f$ by tridiagonal solve for second derivatives.
+ *              Since grid is uniform, the interval of a point is found by \f$ \lfloor (x-x_0)/h \rfloor \f$,
+ *              so evaluation at many points is a single vectorised pass without binary search.
+ *              Interpolation error is \f$ \mathcal{O}(h^2) \f$ near the ends and \f$ \mathcal{O}(h^4) \f$ inside,
+ *              scaled by the function derivatives.
+ */
+class UniformCubicSpline
+{
+private:
+    //! First grid node.
+    double x_0;
+
+    //! Grid step.
+    double h;
+
+    //! Function values at grid nodes.
+    Eigen::RowVectorXd values;
+
+    //! Spline second derivatives at grid nodes.
+    Eigen::RowVectorXd second_derivatives;
+public:
+    /**
+     * @brief   A spline constructor
+     *
+     * @details If h is non-positive or there are less than 3 values, std::invalid_argument is thrown.
+     *
+     * @param   x_0     First grid node
+     * @param   h       Grid step
+     * @param   values  Function values at nodes \f$ x_0 + ih \f$
+     */
+    UniformCubicSpline(double x_0, double h, const Eigen::RowVectorXd &values);
+
+    //! Get first grid node.
+    double get_lower();
+
+    //! Get last grid node.
+    double get_upper();
+
+    /**
+     * @brief   Evaluate spline at given points
+     *
+     * @details Points within a few ulps outside of grid are evaluated at its end nodes,
+     *          if any other point is outside of grid, std::invalid_argument is thrown.
+     *
+     * @param   x       Vector of points
+     *
+     * @return          vector of spline values of x shape.
+     */
+    Eigen::RowVectorXd evaluate(const Eigen::RowVectorXd &x);
+};
+
+#endif  // INTERPOLATION_H
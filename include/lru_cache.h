@@ -0,0 +1,204 @@
+/**
+ * @file
+ * @brief Bounded cache of least recently used values shared by pricers and model policies.
+ */
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <list>
+#include <map>
+#include <utility>
+#include <stdexcept>
+
+//! Default entries count of LruCache.
+#define LRU_CACHE_CAPACITY 16
+
+/**
+ * @brief               A bounded map evicting least recently used entries
+ *
+ * @details             Values cached per maturity or per parameters would grow without limit when these vary
+ *                      (e.g. during calibration), so at most capacity entries are kept and the least recently
+ *                      found or inserted one is evicted first. Lookup is logarithmic in capacity.
+ *                      References returned by find() and insert() stay valid until the entry is evicted.
+ *                      Copies own their entries, so a cache may be copied with the pricer or model holding it.
+ *                      Capacity must be positive.
+ *
+ * @tparam  Key         Ordered key type
+ * @tparam  Value       Cached value type
+ */
+template <typename Key, typename Value>
+class LruCache {
+private:
+    //! Entries from the most to the least recently used.
+    std::list<std::pair<Key, Value> > entries;
+
+    //! Positions of entries by key.
+    std::map<Key, typename std::list<std::pair<Key, Value> >::iterator> positions;
+
+    //! Maximal entries count.
+    int capacity;
+
+    /**
+     * @brief           Rebuild positions of entries, which must not refer to list of another cache
+     */
+    void index_entries();
+public:
+    /**
+     * @brief           A cache constructor
+     *
+     * @details         If capacity is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   capacity    Maximal entries count.
+     */
+    LruCache(int capacity = LRU_CACHE_CAPACITY);
+
+    /**
+     * @brief           A cache copy constructor
+     *
+     * @details         Entries are copied in the same order, positions refer to the copied entries.
+     */
+    LruCache(const LruCache &other);
+
+    /**
+     * @brief           A cache copy assignment
+     *
+     * @details         Entries are copied in the same order, positions refer to the copied entries.
+     */
+    LruCache &operator=(const LruCache &other);
+
+    /**
+     * @brief           Find value of given key and mark it as the most recently used
+     *
+     * @return          pointer to cached value, NULL if key is not cached.
+     */
+    Value *find(const Key &key);
+
+    /**
+     * @brief           Cache value of given key, the least recently used entry is evicted if cache is full
+     *
+     * @return          reference to cached value.
+     */
+    Value &insert(const Key &key, const Value &value);
+
+    /**
+     * @brief           Remove all entries
+     */
+    void clear();
+
+    /**
+     * @brief           Get entries count
+     */
+    int size();
+
+    /**
+     * @brief           Capacity setter
+     *
+     * @details         The least recently used entries above capacity are evicted.
+     *                  If capacity is non-positive, std::invalid_argument is thrown.
+     */
+    void set_capacity(int capacity);
+
+    /**
+     * @brief           Get maximal entries count
+     */
+    int get_capacity();
+};
+
+template <typename Key, typename Value>
+LruCache<Key, Value>::LruCache(int _capacity)
+{
+    set_capacity(_capacity);
+}
+
+template <typename Key, typename Value>
+LruCache<Key, Value>::LruCache(const LruCache &other) :
+    entries(other.entries),
+    capacity(other.capacity)
+{
+    index_entries();
+}
+
+template <typename Key, typename Value>
+LruCache<Key, Value> &LruCache<Key, Value>::operator=(const LruCache &other)
+{
+    if (this != &other) {
+        entries = other.entries;
+        capacity = other.capacity;
+        index_entries();
+    }
+    return *this;
+}
+
+template <typename Key, typename Value>
+void LruCache<Key, Value>::index_entries()
+{
+    positions.clear();
+    typename std::list<std::pair<Key, Value> >::iterator entry;
+    for (entry=entries.begin(); entry!=entries.end(); entry++) {
+        positions[entry->first] = entry;
+    }
+}
+
+template <typename Key, typename Value>
+Value *LruCache<Key, Value>::find(const Key &key)
+{
+    typename std::map<Key, typename std::list<std::pair<Key, Value> >::iterator>::iterator position = positions.find(key);
+    if (position == positions.end()) {
+        return NULL;
+    }
+
+    // Moving list node keeps references to its value valid
+    entries.splice(entries.begin(), entries, position->second);
+    return &position->second->second;
+}
+
+template <typename Key, typename Value>
+Value &LruCache<Key, Value>::insert(const Key &key, const Value &value)
+{
+    Value *cached = find(key);
+    if (cached != NULL) {
+        *cached = value;
+        return *cached;
+    }
+    entries.push_front(std::make_pair(key, value));
+    positions[key] = entries.begin();
+    while ((int)entries.size() > capacity) {
+        positions.erase(entries.back().first);
+        entries.pop_back();
+    }
+    return entries.front().second;
+}
+
+template <typename Key, typename Value>
+void LruCache<Key, Value>::clear()
+{
+    entries.clear();
+    positions.clear();
+}
+
+template <typename Key, typename Value>
+int LruCache<Key, Value>::size()
+{
+    return entries.size();
+}
+
+template <typename Key, typename Value>
+void LruCache<Key, Value>::set_capacity(int _capacity)
+{
+    if (_capacity <= 0) {
+        throw std::invalid_argument("Cache capacity must be non-negative.");
+    }
+    capacity = _capacity;
+    while ((int)entries.size() > capacity) {
+        positions.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+template <typename Key, typename Value>
+int LruCache<Key, Value>::get_capacity()
+{
+    return capacity;
+}
+
+#endif  // LRU_CACHE_H
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Non-uniform FFT algorithm implementation.
+ */
+#ifndef NUFFT_H
+#define NUFFT_H
+
+#include "fft.h"
+
+/**
+ * @brief           Calculate trigonometric sum at arbitrary points by Non-uniform FFT
+ *
+ * @details         Calculates \f$ F_j = \sum_{n=0}^{N-1}f_n e^{-in\theta_j} \f$ for arbitrary real \f$ \theta_j \f$
+ *                  (NUFFT of type 2) by Gaussian gridding: coefficients are divided by Fourier coefficients
+ *                  of a periodic Gaussian kernel, transformed by FFT on twice oversampled grid of size 2N,
+ *                  then the kernel is spread back to every \f$ \theta_j \f$ by 24 nearest grid points.
+ *                  Absolute error is about \f$ 10^{-12}\sum|f_n| \f$.
+ *                  Time complexity is \f$ \mathcal{O}(Nlog(N) + M) \f$ for M points.
+ *
+ * @param   coefficients    Vector of complex coefficients \f$ f_n \f$
+ * @param   phases          Vector of points \f$ \theta_j \f$
+ *
+ * @return          vector of sums of phases shape.
+ *
+ * @see             Greengard, Lee (2004), Accelerating the Nonuniform Fast Fourier Transform
+ */
+Eigen::RowVectorXcd nufft(const Eigen::RowVectorXcd &coefficients, const Eigen::RowVectorXd &phases);
+
+#endif  // NUFFT_H
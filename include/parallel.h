@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @brief Worker threads helper shared by calibration and char. function solvers.
+ */
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <exception>
+
+/**
+ * @brief           Run tasks on worker threads
+ *
+ * @details         Task indices are distributed among threads by stride, calling thread is a worker too.
+ *                  If a task throws, its worker stops taking tasks, all threads are joined and the exception
+ *                  of the first such worker is rethrown to the caller.
+ *
+ * @param   tasks_count     Count of tasks
+ * @param   threads_count   Maximal count of threads
+ * @param   task            Callable object taking task index
+ */
+template <typename Task>
+inline void run_parallel(int tasks_count, int threads_count, Task task)
+{
+    int workers = std::max(1, std::min(threads_count, tasks_count));
+    std::vector<std::exception_ptr> errors(workers);
+    auto worker = [&](int first) {
+        try {
+            for (int index=first; index<tasks_count; index+=workers) {
+                task(index);
+            }
+        } catch (...) {
+            // Exception must not leave a thread, otherwise std::terminate is called
+            errors[first] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int first=1; first<workers; first++) {
+        threads.push_back(std::thread(worker, first));
+    }
+    worker(0);
+    for (int t=0; t<(int)threads.size(); t++) {
+        threads[t].join();
+    }
+    for (int first=0; first<workers; first++) {
+        if (errors[first]) {
+            std::rethrow_exception(errors[first]);
+        }
+    }
+}
+
+#endif  // PARALLEL_H
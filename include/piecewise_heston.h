@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @brief Heston model with piecewise constant parameteres policy of FourierPricer.
+ */
+#ifndef PIECEWISE_HESTON_H
+#define PIECEWISE_HESTON_H
+
+#include <vector>
+#include <algorithm>
+
+#include "lru_cache.h"
+#include "heston_model.h"
+
+/**
+ * @brief       Coefficients of Heston Riccati equations propagation over a time interval
+ *
+ * @details     Started at \f$ D_0 \f$, Riccati equations of heston_cf_coefficients() give after time \f$ \tau \f$
+ *              \f$ D = \frac{n - fD_0}{l - sD_0} \f$ and increment \f$ C = c - \frac{2\kappa\theta}{\sigma^2}\ln(l - sD_0) \f$ with
+ *              \f$ l = \frac{b+d-(b-d)E}{2d} \f$, \f$ s = \frac{\sigma^2(1-E)}{2d} \f$, \f$ n = -\frac{(iu+u^2)(1-E)}{2d} \f$,
+ *              \f$ f = \frac{b-d-(b+d)E}{2d} \f$, \f$ c = \frac{\kappa\theta}{\sigma^2}(b-d)\tau \f$, \f$ E = e^{-d\tau} \f$.
+ *              At \f$ D_0 = 0 \f$ these are heston_cf_coefficients() formulas.
+ */
+struct HestonPropagation {
+    //! Coefficients \f$ l, s \f$ of denominator.
+    Eigen::RowVectorXcd level, slope;
+
+    //! Coefficients \f$ n, f \f$ of numerator.
+    Eigen::RowVectorXcd numerator, feedback;
+
+    //! Increment \f$ c \f$ of C at \f$ D_0 = 0 \f$ apart from logarithm.
+    Eigen::RowVectorXcd drift;
+};
+
+/**
+ * @brief       Heston model with piecewise constant parameteres policy of FourierPricer
+ *
+ * @details     Parameteres \f$ (\rho_j, \kappa_j, \theta_j, \sigma_j) \f$ are constant on intervals \f$ (t_{j-1}, t_j] \f$,
+ *              \f$ t_0 = 0 \f$, the last interval is unbounded, so term structures of vol-of-vol and mean reversion
+ *              are fitted by maturity buckets. Char. function is found by recursion of closed-form solutions: Riccati
+ *              equations run backward from maturity and start every interval at the value reached on the later one.
+ *              Propagation over an interval is a Mobius map of D (see HestonPropagation) whose coefficients do not
+ *              depend on maturity, so they are calculated once per grid and interval (when a maturity beyond the
+ *              interval is priced first, hence pricing in increasing order extends them by one interval at a time).
+ *              Then a maturity costs one exponent for the interval containing it and a division and a logarithm per
+ *              earlier interval, so only these coefficients are reused incrementally, not the recursion itself:
+ *              maps of D compose as 2x2 matrix products, but every interval adds its denominator logarithm to C
+ *              with its own weight \f$ 2\kappa_j\theta_j/\sigma_j^2 \f$, so C is not the logarithm of the composed
+ *              denominator and needs the states entering earlier intervals, which depend on maturity.
+ *              Log char. functions of LRU_CACHE_CAPACITY least recently used maturities are cached.
+ *              Parameteres must be positive, interval ends must be positive and increasing.
+ *              See HestonModel for the policy interface.
+ */
+class PiecewiseHestonModel {
+private:
+    //! Increasing ends \f$ t_1, \dots, t_{n-1} \f$ of bounded intervals.
+    std::vector<double> times;
+
+    //! Heston model parameteres structs of n intervals.
+    std::vector<HestonParams> params;
+
+    //! Initial variance value.
+    double v_0;
+
+    //! Grid of arguments of cached terms.
+    Eigen::RowVectorXcd grid;
+
+    //! Terms \f$ iu \f$ and \f$ iu + u^2 \f$ at grid shared by intervals.
+    Eigen::RowVectorXcd i_u, i_u_u2;
+
+    //! Flags of intervals whose terms are calculated at grid.
+    std::vector<bool> prepared;
+
+    //! Terms \f$ b - d \f$ and \f$ d \f$ of intervals at grid, \f$ b = \kappa - \rho\sigma iu \f$.
+    std::vector<Eigen::RowVectorXcd> b_minus_d, d;
+
+    //! Propagation over bounded intervals at grid.
+    std::vector<HestonPropagation> propagation;
+
+    //! Log char. functions at grid by recently priced maturity.
+    LruCache<double, Eigen::RowVectorXcd> cf_cache;
+
+    /**
+     * @brief           Calculate maturity independent terms of an interval at grid
+     *
+     * @param   interval    Interval index
+     */
+    void prepare_interval(int interval);
+
+    /**
+     * @brief           Calculate propagation coefficients of an interval at grid
+     *
+     * @param   interval    Interval index
+     * @param   tau         Time of propagation
+     * @param   result      Output coefficients
+     */
+    void interval_propagation(int interval, double tau, HestonPropagation &result);
+
+    /**
+     * @brief           Check interval index
+     *
+     * @details         If index is outside of [0, n), std::invalid_argument is thrown.
+     */
+    void check_interval(int interval);
+public:
+    /**
+     * @brief           A model constructor
+     *
+     * @details         If interval ends are not positive and increasing, parameteres count is not
+     *                  interval ends count plus one or v_0 is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   times   Increasing ends \f$ t_1, \dots, t_{n-1} \f$ of bounded intervals
+     * @param   params  Heston model parameteres structs of n intervals
+     * @param   v_0     Initial variance value
+     */
+    PiecewiseHestonModel(const std::vector<double> &times, const std::vector<HestonParams> &params, double v_0);
+
+    /**
+     * @brief           Calculate logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$
+     *
+     * @param   u       Grid of complex arguments of char. function
+     * @param   T       Time to maturity
+     * @param   result  Output vector of u shape
+     */
+    void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result);
+
+    /**
+     * @brief           Get critical moments of \f$ \frac{F_T}{F} \f$
+     *
+     * @details         See piecewise_heston_critical_moments().
+     */
+    std::pair<double, double> moment_strip(double T);
+
+    /**
+     * @brief           Heston model parameteres of an interval setter
+     *
+     * @details         Cached terms of the interval and log char. functions are cleared.
+     */
+    void set_params(int interval, const HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres of an interval
+     */
+    HestonParams get_params(int interval);
+
+    /**
+     * @brief           Get ends of bounded intervals
+     */
+    std::vector<double> get_times();
+
+    /**
+     * @brief           Initial variance value setter
+     *
+     * @details         Cached log char. functions are cleared. If v_0 is non-positive, std::invalid_argument is thrown.
+     */
+    void set_v0(double v_0);
+
+    /**
+     * @brief           Get initial variance value
+     */
+    double get_v0();
+
+    /**
+     * @brief           Clear cached terms and log char. functions
+     */
+    void clear_cache();
+};
+
+#endif  // PIECEWISE_HESTON_H
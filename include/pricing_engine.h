@@ -0,0 +1,258 @@
+/**
+ * @file
+ * @brief Pricing engine choosing the cheapest Heston pricing method for a request.
+ */
+#ifndef PRICING_ENGINE_H
+#define PRICING_ENGINE_H
+
+#include <limits>
+#include <chrono>
+
+#include "heston_pricing.h"
+#include "heston_cos.h"
+#include "heston_lewis.h"
+
+//! Methods of european options pricing available to PricingEngine.
+enum PricingMethod
+{
+    //! FFT on log strikes grid and cubic spline interpolation.
+    FFT_SPLINE_METHOD,
+
+    //! Carr-Madan sum at given strikes by non-uniform FFT.
+    FFT_NUFFT_METHOD,
+
+    //! Carr-Madan sum at given strikes by direct summation.
+    DIRECT_METHOD,
+
+    //! Fang-Oosterlee COS method.
+    COS_METHOD,
+
+    //! Lewis formula by Gauss-Laguerre quadrature.
+    LEWIS_METHOD
+};
+
+/**
+ * @brief       Cost model constants of PricingEngine
+ *
+ * @details     Every constant is a time in seconds of one elementary operation of pricing methods.
+ *              Elements of structure must be positive.
+ */
+struct PricingCosts
+{
+    //! Char. function evaluation at one point
+    double char_function;
+
+    //! FFT time divided by \f$ N\log_2N \f$
+    double fft;
+
+    //! Direct summation step per term and strike
+    double recurrence;
+
+    //! COS method work per term and strike
+    double cos_term;
+
+    //! Lewis formula work per node and strike
+    double lewis_term;
+
+    //! Cubic spline work per node or evaluated point
+    double interpolation;
+};
+
+/**
+ * @brief               A front-end of Heston model european options calculators
+ *
+ * @details             For every request (maturity and strikes) the engine estimates cost and accuracy
+ *                      of every PricingMethod and routes the request to the cheapest one meeting the tolerance:
+ *                      full smiles favour FFT, a few strikes favour direct summation and quadratures,
+ *                      short maturities favour COS and Lewis methods, whose accuracy does not depend
+ *                      on log strikes grid step. Carr-Madan methods use the given HestonEuropeanOptionCalculator
+ *                      parameters, series sizes of COS and Lewis methods are chosen per request.
+ *                      Cost model is calibratable by calibrate_cost_model() startup benchmark.
+ *                      Tolerance must be positive.
+ */
+class PricingEngine {
+private:
+    //! Risk-free interest rate.
+    double r;
+
+    //! Initial stock price.
+    double s_0;
+
+    //! Initial volatility value.
+    double v_0;
+
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Carr-Madan calculator.
+    HestonEuropeanOptionCalculator fft_calculator;
+
+    //! COS method calculator.
+    HestonCosCalculator cos_calculator;
+
+    //! Lewis formula calculator.
+    HestonLewisCalculator lewis_calculator;
+
+    //! Absolute price tolerance.
+    double tolerance;
+
+    //! Cost model constants.
+    PricingCosts costs;
+
+    /**
+     * @brief           Calculate discount factor \f$ B(t,T)e^{-r(T-t)} \f$.
+     *
+     * @param   t       Current time value
+     * @param   T       Terminal time value
+     */
+    double df(double t, double T);
+
+    /**
+     * @brief           Estimate error of Carr-Madan sum at given log strikes
+     *
+     * @details         Sum of integrand tail beyond \f$ N\Delta u \f$ and aliasing error \f$ F e^{-2\pi\alpha/\Delta u} \f$,
+     *                  both multiplied by the damping factor \f$ e^{-\alpha k} \f$.
+     *
+     * @param   T           Time to maturity
+     * @param   log_strikes Vector of log strikes values
+     */
+    double carr_madan_error(double T, const Eigen::RowVectorXd &log_strikes);
+
+    /**
+     * @brief           Get series size of COS or Lewis method for a request
+     *
+     * @details         Smallest power of two meeting the tolerance is chosen, or the largest size allowed.
+     *                  For other methods 0 is returned.
+     */
+    int series_size(PricingMethod method, double T, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Estimate error of COS or Lewis method of given series size
+     */
+    double series_error(PricingMethod method, int size, double T, const Eigen::RowVectorXd &strikes);
+public:
+    /**
+     * @brief           An engine constructor
+     *
+     * @details         If r or s_0 or v_0 or tolerance are non-positive, std::invalid_argument is thrown,
+     *                  Carr-Madan parameteres are checked by HestonEuropeanOptionCalculator.
+     *                  Cost model is initialized by default constants, see calibrate_cost_model().
+     *
+     * @param   r           Risk-free interest rate.
+     * @param   s_0         Initial stock price.
+     * @param   v_0         Initial volatility value.
+     * @param   params      Heston model parameteres struct.
+     * @param   alpha       Exponent Carr-Madan parameter.
+     * @param   N           Carr-Madan integral discretization elements count.
+     * @param   d_u         Carr-Madan char. function argument grid step \f$\Delta u>0\f$.
+     * @param   tolerance   Absolute price tolerance.
+     */
+    PricingEngine(
+        double r,
+        double s_0,
+        double v_0,
+        HestonParams &params,
+        double alpha,
+        int N,
+        double d_u,
+        double tolerance
+    );
+
+    /**
+     * @brief           Absolute price tolerance setter
+     *
+     * @details         If tolerance is non-positive, std::invalid_argument is thrown.
+     */
+    void set_tolerance(double tolerance);
+
+    /**
+     * @brief           Get absolute price tolerance
+     */
+    double get_tolerance();
+
+    /**
+     * @brief           Cost model constants setter
+     *
+     * @details         If any constant is non-positive, std::invalid_argument is thrown.
+     */
+    void set_costs(const PricingCosts &costs);
+
+    /**
+     * @brief           Get cost model constants
+     */
+    PricingCosts get_costs();
+
+    /**
+     * @brief           Calibrate cost model by timing elementary operations
+     *
+     * @details         Every operation is repeated until at least a millisecond is elapsed,
+     *                  so calibration takes about ten milliseconds. Per strike costs of COS and Lewis
+     *                  methods are measured by the calculators themselves.
+     *
+     * @return          calibrated cost model constants.
+     */
+    PricingCosts calibrate_cost_model();
+
+    /**
+     * @brief           Estimate time of pricing a request by given method
+     *
+     * @details         Time is \f$ c_{cf}n \f$ of char. function evaluations plus method specific work:
+     *                      1) FFT_SPLINE_METHOD: \f$ c_{fft}N\log_2N + c_{int}(N+m) \f$,
+     *                      2) FFT_NUFFT_METHOD: \f$ c_{fft}2N\log_2 2N + c_{int}\cdot24m \f$,
+     *                      3) DIRECT_METHOD: \f$ c_{rec}Nm \f$,
+     *                      4) COS_METHOD: \f$ c_{cos}nm \f$,
+     *                      5) LEWIS_METHOD: \f$ c_{lewis}nm \f$,
+     *                  where m is strikes count and n is series size.
+     *
+     * @param   method  Pricing method
+     * @param   option  European option with given time to maturity
+     * @param   strikes Vector of strikes values
+     *
+     * @return          estimated time in seconds.
+     */
+    double estimate_cost(PricingMethod method, EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Estimate absolute price error of given method
+     *
+     * @details         Errors are estimated by char. function tails at methods cut-off frequencies,
+     *                  spline error is estimated by \f$ \frac{5}{384}\Delta k^4 \max|C''''| \f$ with
+     *                  lognormal density of expected average variance. If a method is not applicable
+     *                  (strikes outside of log strikes grid, infinite moments), infinity is returned.
+     *
+     * @param   method  Pricing method
+     * @param   option  European option with given time to maturity
+     * @param   strikes Vector of strikes values
+     *
+     * @return          estimated absolute price error.
+     */
+    double estimate_error(PricingMethod method, EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Choose the cheapest method meeting the tolerance
+     *
+     * @details         If none of methods meets the tolerance, the most accurate one is chosen.
+     *                  For empty strikes DIRECT_METHOD is returned, since it does no work per strike.
+     *
+     * @param   option  European option with given time to maturity
+     * @param   strikes Vector of strikes values
+     */
+    PricingMethod choose_method(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+
+    /**
+     * @brief           Calculate european option prices at given strikes by the chosen method
+     *
+     * @details         If any strike is non-positive, std::invalid_argument is thrown.
+     *                  Empty strikes give an empty vector of prices.
+     *
+     * @param   option  European option with given time to maturity and type
+     * @param   strikes Vector of strikes values
+     *
+     * @return          vector of prices of strikes shape.
+     *
+     * @see             choose_method()
+     */
+    Eigen::RowVectorXd calculate(EuropeanOption &option, const Eigen::RowVectorXd &strikes);
+};
+
+#endif  // PRICING_ENGINE_H
@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @brief Gaussian quadrature rules.
+ */
+#ifndef QUADRATURE_H
+#define QUADRATURE_H
+
+#include <stdexcept>
+#include <cmath>
+#include <Eigen/Dense>
+
+/**
+ * @brief           Calculate Gauss-Laguerre quadrature nodes and weights
+ *
+ * @details         Nodes are eigenvalues of the Jacobi matrix of Laguerre polynomials (Golub-Welsch),
+ *                  refined by Newton steps on \f$ L_n \f$. Weights are calculated from
+ *                  \f$ w_i = \frac{x_i}{(n+1)^2L_{n+1}(x_i)^2} \f$ and returned multiplied by \f$ e^{x_i} \f$,
+ *                  so that \f$ \int_0^\infty f(x)dx \approx \sum_i w_i f(x_i) \f$.
+ *                  If n is non-positive or greater than 128 (weights overflow), std::invalid_argument is thrown.
+ *
+ * @param   n       Nodes count
+ * @param   nodes   Output vector of nodes \f$ x_i \f$ (resized to n)
+ * @param   weights Output vector of weights \f$ w_ie^{x_i} \f$ (resized to n)
+ */
+void gauss_laguerre(int n, Eigen::RowVectorXd &nodes, Eigen::RowVectorXd &weights);
+
+/**
+ * @brief           Calculate Gauss-Legendre quadrature nodes and weights on \f$ [-1, 1] \f$
+ *
+ * @details         Nodes are eigenvalues of the Jacobi matrix of Legendre polynomials (Golub-Welsch),
+ *                  refined by Newton steps on \f$ P_n \f$. Weights are \f$ w_i = \frac{2}{(1-x_i^2)P_n'(x_i)^2} \f$.
+ *                  If n is non-positive, std::invalid_argument is thrown.
+ *
+ * @param   n       Nodes count
+ * @param   nodes   Output vector of increasing nodes \f$ x_i \f$ (resized to n)
+ * @param   weights Output vector of weights \f$ w_i \f$ (resized to n)
+ */
+void gauss_legendre(int n, Eigen::RowVectorXd &nodes, Eigen::RowVectorXd &weights);
+
+#endif  // QUADRATURE_H
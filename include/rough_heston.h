@@ -0,0 +1,227 @@
+/**
+ * @file
+ * @brief Rough Heston model policy of FourierPricer by multi-factor Markovian approximation.
+ */
+#ifndef ROUGH_HESTON_H
+#define ROUGH_HESTON_H
+
+#include <vector>
+#include <thread>
+
+#include "parallel.h"
+#include "lru_cache.h"
+#include "heston_model.h"
+
+/**
+ * @brief       Rough Heston model policy of FourierPricer
+ *
+ * @details     Variance of rough Heston model is a Volterra process with fractional kernel
+ *              \f$ K(t) = \frac{t^{H-1/2}}{\Gamma(H+1/2)} \f$, \f$ 0 < H < 1/2 \f$, and Heston parameteres
+ *              \f$ (\rho, \kappa, \theta, \sigma) \f$. Its char. function solves fractional Riccati equation, whose
+ *              direct Adams scheme costs \f$ O(n^2) \f$ per argument. Instead kernel is approximated by
+ *              \f$ \sum_{i=1}^m c_ie^{-x_it} \f$, a quadrature of its Laplace measure (Gauss-Legendre rule in \f$ \ln x \f$
+ *              and the mass near zero at its mean, as in lifted Heston model of Abi Jaber and El Euch), then
+ *              \f$ \psi = \sum_i c_i\psi_i \f$ solves m ordinary Riccati equations
+ *              \f$ \psi_i' = -x_i\psi_i + F(u,\psi) \f$, \f$ F = \frac{-u^2-iu}{2} + (iu\rho\sigma-\kappa)\psi + \frac{\sigma^2}{2}\psi^2 \f$, and
+ *              \f$ \ln\varphi(u,T) = \left(v_0 + \kappa\theta\sum_i\frac{c_i}{x_i}\right)\int_0^TF(u,\psi)\,dt
+ *              - \kappa\theta\sum_i\frac{c_i}{x_i}\psi_i(T) \f$.
+ *              So every maturity is read from one forward march in time. Factors share the forcing F, so their
+ *              linear parts are integrated exactly and the implicit step is a quadratic equation of aggregated
+ *              solution solved in closed form, which costs O(m) per argument and is stable for stiff factors.
+ *              Time grid is graded near zero and shared by maturities: state at the last grid node is kept,
+ *              so maturities priced in increasing order march only once (a maturity between nodes is finished by
+ *              a partial step on a copy, hence results do not depend on the order of calls). Blocks of arguments
+ *              are marched by threads.
+ *              Critical moments are found by marching on real arguments: many moment orders are marched at once
+ *              and the explosion is bracketed by doubling and refined by multisection.
+ *              Log char. functions and critical moments of LRU_CACHE_CAPACITY least recently used maturities
+ *              are cached.
+ *              Parameteres must be positive, Hurst exponent is in (0, 1/2).
+ *              See HestonModel for the policy interface.
+ */
+class RoughHestonModel {
+private:
+    //! Heston model parameteres struct.
+    HestonParams params;
+
+    //! Hurst exponent H.
+    double hurst;
+
+    //! Initial variance value.
+    double v_0;
+
+    //! Count of kernel factors.
+    int factors;
+
+    //! Time step of Riccati equations.
+    double time_step;
+
+    //! Threads count used to march arguments grid.
+    int threads_count;
+
+    //! Weights \f$ c_i \f$ and mean reversions \f$ x_i \f$ of kernel factors.
+    Eigen::ArrayXd weights, nodes;
+
+    //! Grid of arguments of march state.
+    Eigen::RowVectorXcd grid;
+
+    //! Constant \f$ \frac{-u^2-iu}{2} \f$ and linear \f$ iu\rho\sigma-\kappa \f$ terms of F at grid.
+    Eigen::ArrayXXcd constant, linear;
+
+    //! Time of the last grid node marched.
+    double time;
+
+    //! March state at last node: factor solutions (factors x grid), F and its time integral (1 x grid).
+    Eigen::ArrayXXcd psi, riccati, integral;
+
+    //! Log char. functions at grid by recently priced maturity.
+    LruCache<double, Eigen::RowVectorXcd> cf_cache;
+
+    //! Critical moments by recently priced maturity.
+    LruCache<double, std::pair<double, double> > strip_cache;
+
+    /**
+     * @brief           Calculate kernel factors of geometric partition and reset march
+     */
+    void set_kernel();
+
+    /**
+     * @brief           Reset march state and clear caches
+     */
+    void reset();
+
+    /**
+     * @brief           March Riccati equations of given arguments by given steps in parallel
+     *
+     * @param   constant    Constant terms of F by columns
+     * @param   linear      Linear terms of F by columns
+     * @param   steps       Time steps
+     * @param   psi         Factor solutions (factors x columns), updated
+     * @param   riccati     F at psi (1 x columns), updated
+     * @param   integral    Time integral of F (1 x columns), updated
+     * @param   exploded    Flags of columns whose solutions exploded (1 x columns), updated
+     */
+    void advance(
+        const Eigen::ArrayXXcd &constant,
+        const Eigen::ArrayXXcd &linear,
+        const std::vector<double> &steps,
+        Eigen::ArrayXXcd &psi,
+        Eigen::ArrayXXcd &riccati,
+        Eigen::ArrayXXcd &integral,
+        Eigen::Array<bool, 1, Eigen::Dynamic> &exploded
+    );
+
+    /**
+     * @brief           Get flags of exploded moments of given orders at maturity
+     *
+     * @param   omega   Moment orders
+     * @param   T       Time to maturity
+     */
+    Eigen::Array<bool, 1, Eigen::Dynamic> moments_exploded(const Eigen::RowVectorXd &omega, double T);
+public:
+    /**
+     * @brief           A model constructor
+     *
+     * @details         If v_0 is non-positive, Hurst exponent is outside of (0, 1/2), factors count is less than 2
+     *                  or time step is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   params      Heston model parameteres struct
+     * @param   hurst       Hurst exponent H
+     * @param   v_0         Initial variance value
+     * @param   factors     Count of kernel factors
+     * @param   time_step   Time step of Riccati equations
+     */
+    RoughHestonModel(
+        const HestonParams &params,
+        double hurst,
+        double v_0,
+        int factors = 20,
+        double time_step = 0.02
+    );
+
+    /**
+     * @brief           Calculate logarithm of char. function of \f$ \ln\frac{F_T}{F} \f$
+     *
+     * @param   u       Grid of complex arguments of char. function
+     * @param   T       Time to maturity
+     * @param   result  Output vector of u shape
+     */
+    void log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result);
+
+    /**
+     * @brief           Get critical moments of \f$ \frac{F_T}{F} \f$
+     *
+     * @details         Moments are explosive when Riccati solution at real argument exceeds a bound or crosses a pole
+     *                  within a step, so bounds are accurate up to time discretization.
+     */
+    std::pair<double, double> moment_strip(double T);
+
+    /**
+     * @brief           Heston model parameteres setter
+     */
+    void set_params(const HestonParams &params);
+
+    /**
+     * @brief           Get Heston model parameteres
+     */
+    HestonParams get_params();
+
+    /**
+     * @brief           Hurst exponent setter
+     *
+     * @details         If Hurst exponent is outside of (0, 1/2), std::invalid_argument is thrown.
+     */
+    void set_hurst(double hurst);
+
+    /**
+     * @brief           Get Hurst exponent
+     */
+    double get_hurst();
+
+    /**
+     * @brief           Initial variance value setter
+     *
+     * @details         If v_0 is non-positive, std::invalid_argument is thrown.
+     */
+    void set_v0(double v_0);
+
+    /**
+     * @brief           Get initial variance value
+     */
+    double get_v0();
+
+    /**
+     * @brief           Discretization setter
+     *
+     * @details         If factors count is less than 2 or time step is non-positive, std::invalid_argument is thrown.
+     *
+     * @param   factors     Count of kernel factors
+     * @param   time_step   Time step of Riccati equations
+     */
+    void set_discretization(int factors, double time_step);
+
+    /**
+     * @brief           Get count of kernel factors
+     */
+    int get_factors();
+
+    /**
+     * @brief           Get time step of Riccati equations
+     */
+    double get_time_step();
+
+    /**
+     * @brief           Threads count setter
+     *
+     * @details         If threads count is non-positive, std::invalid_argument is thrown.
+     *                  By default it is hardware concurrency.
+     */
+    void set_threads_count(int threads_count);
+
+    /**
+     * @brief           Get threads count
+     */
+    int get_threads_count();
+};
+
+#endif  // ROUGH_HESTON_H
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @brief Static arbitrage and numerical health checks of computed prices surfaces.
+ */
+#ifndef SURFACE_CHECKS_H
+#define SURFACE_CHECKS_H
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <Eigen/Dense>
+
+/**
+ * @brief       Diagnostics of one strike region of checked prices
+ *
+ * @details     Every counter is a number of violations exceeding the checker tolerance,
+ *              a violation is attributed to the strike in the middle of the checked strikes
+ *              (left one for call spreads). Non-finite prices are counted only by non_finite.
+ */
+struct SurfaceDiagnostics
+{
+    //! Lower strike bound of region (inclusive)
+    double K_lower;
+
+    //! Upper strike bound of region (exclusive)
+    double K_upper;
+
+    //! Count of checked prices
+    int count;
+
+    //! Count of NaN or infinite prices
+    int non_finite;
+
+    //! Count of call spreads violations: price increases in strike or falls faster than discounted strike
+    int monotonicity;
+
+    //! Count of negative butterflies
+    int convexity;
+
+    //! Count of prices outside of Call-Put Parity bounds \f$ \max(s_0 - KB(0,T), 0) \leq C \leq s_0 \f$
+    int parity;
+
+    //! Count of negative calendar spreads (call price decreases in maturity at fixed strike)
+    int calendar;
+
+    //! Largest violation amount in price units (0 if there are no violations)
+    double worst;
+
+    //! Strike of the largest violation
+    double worst_strike;
+
+    //! Time to maturity of the largest violation
+    double worst_maturity;
+};
+
+/**
+ * @brief               A checker of static arbitrage and numerical health of prices surfaces
+ *
+ * @details             Badly chosen Carr-Madan parameteres produce negative prices, non-monotone wings
+ *                      or calendar arbitrage. Checker flags them in one vectorised pass over result grid
+ *                      of a maturity or a surface of several maturities (strikes grid is shared), so its
+ *                      cost is a few array operations per price. Put prices are converted to call ones
+ *                      by Call-Put Parity first. Strikes axis is split into regions by increasing bounds,
+ *                      by default the only region is \f$ [0, +\infty) \f$.
+ *                      Risk-free interest rate, initial stock price and tolerance must be positive.
+ */
+class SurfaceChecker {
+private:
+    //! Risk-free interest rate.
+    double r;
+
+    //! Initial stock price.
+    double s_0;
+
+    //! Absolute price tolerance of violations.
+    double tolerance;
+
+    //! Increasing strike bounds of regions.
+    Eigen::RowVectorXd bounds;
+
+    /**
+     * @brief           Check call prices of one maturity and accumulate violations
+     *
+     * @param   strikes     Vector of increasing strikes values
+     * @param   calls       Vector of call prices of strikes shape
+     * @param   T           Time to maturity
+     * @param   diagnostics Diagnostics of regions
+     */
+    void check_smile(
+        const Eigen::RowVectorXd &strikes,
+        const Eigen::RowVectorXd &calls,
+        double T,
+        std::vector<SurfaceDiagnostics> &diagnostics
+    );
+
+    /**
+     * @brief           Accumulate violations of one check into regions
+     *
+     * @param   amounts     Violation amounts of strikes shape (non-positive if there is no violation)
+     * @param   strikes     Vector of increasing strikes values
+     * @param   T           Time to maturity
+     * @param   counter     Counter of the check in SurfaceDiagnostics
+     * @param   diagnostics Diagnostics of regions
+     */
+    void accumulate(
+        const Eigen::RowVectorXd &amounts,
+        const Eigen::RowVectorXd &strikes,
+        double T,
+        int SurfaceDiagnostics::*counter,
+        std::vector<SurfaceDiagnostics> &diagnostics
+    );
+
+    /**
+     * @brief           Create empty diagnostics of regions
+     */
+    std::vector<SurfaceDiagnostics> empty_diagnostics();
+public:
+    /**
+     * @brief           A checker constructor
+     *
+     * @details         If r or s_0 or tolerance are non-positive, std::invalid_argument is thrown.
+     *
+     * @param   r           Risk-free interest rate.
+     * @param   s_0         Initial stock price.
+     * @param   tolerance   Absolute price tolerance of violations.
+     */
+    SurfaceChecker(double r, double s_0, double tolerance);
+
+    /**
+     * @brief           Absolute price tolerance setter
+     *
+     * @details         If tolerance is non-positive, std::invalid_argument is thrown.
+     */
+    void set_tolerance(double tolerance);
+
+    /**
+     * @brief           Get absolute price tolerance
+     */
+    double get_tolerance();
+
+    /**
+     * @brief           Strike regions setter
+     *
+     * @details         Bounds \f$ K_0 < K_1 < \dots < K_m \f$ define m regions \f$ [K_{i-1}, K_i) \f$,
+     *                  e.g. left wing, body and right wing. Strikes outside of all regions are not reported.
+     *                  If there are less than 2 bounds or they are negative or not increasing,
+     *                  std::invalid_argument is thrown.
+     */
+    void set_regions(const Eigen::RowVectorXd &bounds);
+
+    /**
+     * @brief           Get strike bounds of regions
+     */
+    Eigen::RowVectorXd get_regions();
+
+    /**
+     * @brief           Check prices of one maturity
+     *
+     * @details         Non-finite values, call spreads, butterflies and Call-Put Parity bounds are checked.
+     *                  If strikes are not increasing or prices are of other shape, std::invalid_argument is thrown.
+     *
+     * @param   strikes Vector of increasing strikes values
+     * @param   prices  Vector of option prices of strikes shape
+     * @param   T       Time to maturity
+     * @param   is_call Whether options are of call type
+     *
+     * @return          diagnostics of every region.
+     */
+    std::vector<SurfaceDiagnostics> check(
+        const Eigen::RowVectorXd &strikes,
+        const Eigen::RowVectorXd &prices,
+        double T,
+        bool is_call = true
+    );
+
+    /**
+     * @brief           Check prices surface of several maturities
+     *
+     * @details         Every row is checked as by check() of one maturity, calendar spreads
+     *                  are checked between consecutive rows. Diagnostics of all maturities are summed by regions.
+     *                  If strikes or maturities are not increasing or prices are not of shape
+     *                  (maturities count) x (strikes count), std::invalid_argument is thrown.
+     *
+     * @param   strikes     Vector of increasing strikes values
+     * @param   maturities  Vector of increasing times to maturity
+     * @param   prices      Matrix of option prices, rows are maturities
+     * @param   is_call     Whether options are of call type
+     *
+     * @return          diagnostics of every region.
+     */
+    std::vector<SurfaceDiagnostics> check(
+        const Eigen::RowVectorXd &strikes,
+        const Eigen::RowVectorXd &maturities,
+        const Eigen::MatrixXd &prices,
+        bool is_call = true
+    );
+
+    /**
+     * @brief           Check whether diagnostics contain no violations
+     */
+    static bool passed(const std::vector<SurfaceDiagnostics> &diagnostics);
+};
+
+#endif  // SURFACE_CHECKS_H
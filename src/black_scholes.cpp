@@ -0,0 +1,121 @@
+/**
+ * @file
+ * @brief Black-Scholes formulae used for implied volatility quotes and their inversion.
+ */
+#include "black_scholes.h"
+
+//! Maximal count of safeguarded Newton iterations of implied volatility.
+#define IMPLIED_VOL_MAX_ITERATIONS 100
+
+//! Relative step or bracket width of total volatility at which iterations stop.
+#define IMPLIED_VOL_TOLERANCE 1e-13
+
+double normal_cdf(double x)
+{
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double black_scholes_price(bool is_call, double s_0, double strike, double r, double T, double volatility)
+{
+    double df = std::exp(-r * T);
+    double sd = volatility * std::sqrt(T);
+    double d_1 = (std::log(s_0 / (strike * df))) / sd + sd / 2;
+    double d_2 = d_1 - sd;
+    double call = s_0 * normal_cdf(d_1) - strike * df * normal_cdf(d_2);
+    if (is_call) {
+        return call;
+    }
+    return call - s_0 + strike * df;
+}
+
+Eigen::RowVectorXd implied_vols(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &prices,
+    double T,
+    double r,
+    double s_0,
+    bool is_call
+) {
+    typedef Eigen::Array<double, 1, Eigen::Dynamic> RowArrayXd;
+    double forward = s_0 * std::exp(r * T);
+    double df = std::exp(-r * T);
+
+    // Normalised undiscounted call prices, (F - K)/sqrt(FK) = e^{x/2} - e^{-x/2}
+    RowArrayXd x = (forward / strikes.array()).log();
+    RowArrayXd beta = prices.array() / (df * (forward * strikes.array()).sqrt());
+    RowArrayXd intrinsic = (0.5 * x).exp() - (-0.5 * x).exp();
+
+    // Out-of-the-money prices are symmetric (put at x equals call at -x), so take them without cancellation
+    if (is_call) {
+        beta -= intrinsic.max(0.0);
+    } else {
+        beta += intrinsic.min(0.0);
+    }
+    x = -x.abs();
+    RowArrayXd upper = (0.5 * x).exp();
+    RowArrayXd lower_weight = (-0.5 * x).exp();
+    RowArrayXd log_beta = beta.log();
+    Eigen::Array<bool, 1, Eigen::Dynamic> valid = (beta > 0) && (beta < upper);
+
+    // Corrado-Miller initial guess, inflection point sqrt(2|x|) if it has no real value
+    RowArrayXd difference = 0.5 * (upper - lower_weight);
+    RowArrayXd discriminant = (beta - difference).square() - 4 * difference.square() / M_PI;
+    RowArrayXd s = std::sqrt(2 * M_PI) / (upper + lower_weight) * (beta - difference + discriminant.max(0.0).sqrt());
+    s = (s > 0).select(s, (2 * x.abs()).sqrt().max(0.1));
+
+    // Safeguarded Newton iterations on ln b(s) = ln(beta), root is bracketed by [low, high],
+    // converged and invalid elements are frozen
+    RowArrayXd low = RowArrayXd::Zero(x.cols());
+    RowArrayXd high = RowArrayXd::Constant(x.cols(), std::numeric_limits<double>::infinity());
+    Eigen::Array<bool, 1, Eigen::Dynamic> active = valid;
+    auto cdf = [](double d) { return normal_cdf(d); };
+    for (int iteration=0; (iteration<IMPLIED_VOL_MAX_ITERATIONS) && active.any(); iteration++) {
+        RowArrayXd d_1 = x / s + 0.5 * s;
+        RowArrayXd d_2 = d_1 - s;
+        RowArrayXd b = upper * d_1.unaryExpr(cdf) - lower_weight * d_2.unaryExpr(cdf);
+        RowArrayXd vega = upper * (-0.5 * d_1.square()).exp() / std::sqrt(2 * M_PI);
+        high = (b > beta).select(s.min(high), high);
+        low = (b <= beta).select(s.max(low), low);
+
+        // Newton step of log objective, bisection (or doubling with no upper bound) outside of bracket.
+        // Near the root concave ln b(s) may overshoot just past the bracket, so a tiny Newton step converges too
+        RowArrayXd step = (log_beta - b.max(DBL_MIN).log()) * b / vega;
+        active = active && ((step.abs() > IMPLIED_VOL_TOLERANCE * s) || (b < DBL_MIN))
+            && (high - low > IMPLIED_VOL_TOLERANCE * s);
+        RowArrayXd next = s + step;
+        RowArrayXd bisection = (high < std::numeric_limits<double>::infinity()).select(0.5 * (low + high), 2 * s);
+        next = ((next > low) && (next < high) && (b >= DBL_MIN)).select(next, bisection);
+        next = active.select(next, s);
+        active = active && ((next - s).abs() > IMPLIED_VOL_TOLERANCE * s);
+        s = next;
+    }
+
+    // Prices outside of (intrinsic, upper bound) have no implied volatility
+    s = valid.select(s, std::numeric_limits<double>::quiet_NaN());
+    return (s / std::sqrt(T)).matrix();
+}
+
+Eigen::RowVectorXd implied_vols(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &prices,
+    double T,
+    double r,
+    double s_0,
+    bool is_call,
+    double K_lower,
+    double K_upper
+) {
+    // Indices of strikes inside the window
+    std::vector<int> inside;
+    for (int j=0; j<strikes.cols(); j++) {
+        if ((strikes[j] >= K_lower) && (strikes[j] <= K_upper)) {
+            inside.push_back(j);
+        }
+    }
+    Eigen::RowVectorXd result = Eigen::RowVectorXd::Constant(strikes.cols(), std::numeric_limits<double>::quiet_NaN());
+    if (inside.empty()) {
+        return result;
+    }
+    result(inside) = implied_vols(strikes(inside), prices(inside), T, r, s_0, is_call);
+    return result;
+}
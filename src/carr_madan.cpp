@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Carr-Madan discretization shared by FFT pricers.
+ */
+#include "carr_madan.h"
+
+void check_carr_madan_params(double alpha, int N, double d_u)
+{
+    if (alpha <= 0) {
+        throw std::invalid_argument("Parameter alpha must be non-negative.");
+    }
+    if ((N <= 0) || (N % 2 == 1)) {
+        throw std::invalid_argument("Grid size must be non-negative and even.");
+    }
+    if (d_u <= 0) {
+        throw std::invalid_argument("Grid step must be non-negative.");
+    }
+}
+
+Eigen::RowVectorXcd carr_madan_arguments(double alpha, int N, double d_u)
+{
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXd u_grid = Eigen::RowVectorXd::LinSpaced(N, 0, (N-1) * d_u);
+    return (u_grid.array() - (alpha + 1) * i).matrix();
+}
+
+Eigen::RowVectorXcd carr_madan_weights(double alpha, int N, double d_u)
+{
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXd u_grid = Eigen::RowVectorXd::LinSpaced(N, 0, (N-1) * d_u);
+    Eigen::RowVectorXcd weights = (
+        1.0 / (alpha * alpha + alpha - u_grid.array().square() + i * (2 * alpha + 1) * u_grid.array())
+    ).matrix();
+
+    // Trapezoid rule weight at u = 0, real part of integrand is even in u, so the rule is spectrally accurate
+    weights[0] *= 0.5;
+    return weights;
+}
+
+Eigen::RowVectorXd carr_madan_log_strikes(int N, double d_u)
+{
+    double d_k = 2 * M_PI / (d_u * N);
+    return Eigen::RowVectorXd::LinSpaced(N, -N * d_k / 2, (N / 2 - 1) * d_k);
+}
+
+Eigen::RowVectorXd carr_madan_damping(double alpha, double d_u, const Eigen::RowVectorXd &log_strikes)
+{
+    return ((d_u / M_PI) * (-alpha * log_strikes).array().exp()).matrix();
+}
+
+void carr_madan_prices(
+    const Eigen::RowVectorXcd &transform,
+    const Eigen::RowVectorXd &damping,
+    const Eigen::RowVectorXd &strikes,
+    double df,
+    double s_0,
+    bool is_call,
+    Eigen::RowVectorXd &prices
+) {
+    prices.resize(strikes.cols());
+    prices = (df * damping.array() * transform.real().array()).matrix();
+
+    // If option is of put type, use the Put-Call parity
+    if (!is_call) {
+        prices = (prices.array() + df * strikes.array() - s_0).matrix();
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Double Heston model (two independent stochastic variance factors) policy of FourierPricer.
+ */
+#include "double_heston.h"
+
+DoubleHestonModel::DoubleHestonModel(const HestonParams &first, double v_1, const HestonParams &second, double v_2)
+{
+    set_params(0, first);
+    set_params(1, second);
+    set_v0(0, v_1);
+    set_v0(1, v_2);
+}
+
+void DoubleHestonModel::check_factor(int factor)
+{
+    if ((factor != 0) && (factor != 1)) {
+        throw std::invalid_argument("Factor index must be 0 or 1.");
+    }
+}
+
+void DoubleHestonModel::prepare_grid(const Eigen::RowVectorXcd &u)
+{
+    std::complex<double> i(0.0, 1.0);
+    grid = u;
+    i_u = (i * u.array()).matrix();
+    i_u_u2 = (i_u.array() + u.array().square()).matrix();
+    for (int factor=0; factor<2; factor++) {
+        factor_cache[factor].clear();
+        prepare_factor(factor);
+    }
+}
+
+void DoubleHestonModel::prepare_factor(int factor)
+{
+    // Terms of heston_cf_coefficients() which do not depend on maturity, b = kappa - rho*sigma*iu
+    const HestonParams &p = params[factor];
+    Eigen::ArrayXXcd b = p.kappa - (p.rho * p.sigma) * i_u.array();
+    d[factor] = (b.square() + (p.sigma * p.sigma) * i_u_u2.array()).sqrt().matrix();
+    b_minus_d[factor] = (b - d[factor].array()).matrix();
+    g[factor] = (b_minus_d[factor].array() / (b + d[factor].array())).matrix();
+}
+
+const Eigen::RowVectorXcd &DoubleHestonModel::factor_log_cf(int factor, double T)
+{
+    Eigen::RowVectorXcd *cached = factor_cache[factor].find(T);
+    if (cached != NULL) {
+        return *cached;
+    }
+
+    // C + D*v_0 of heston_cf_coefficients() from cached terms
+    const HestonParams &p = params[factor];
+    double sigma_2 = p.sigma * p.sigma;
+    Eigen::ArrayXXcd exp_d = (-T * d[factor].array()).exp();
+    Eigen::ArrayXXcd one_minus_g_exp = 1.0 - g[factor].array() * exp_d;
+    Eigen::ArrayXXcd D = b_minus_d[factor].array() / sigma_2 * (1.0 - exp_d) / one_minus_g_exp;
+    Eigen::ArrayXXcd C = ((p.kappa * p.theta) / sigma_2) * (
+        b_minus_d[factor].array() * T - 2.0 * (one_minus_g_exp / (1.0 - g[factor].array())).log()
+    );
+    return factor_cache[factor].insert(T, (C + v_0[factor] * D).matrix());
+}
+
+void DoubleHestonModel::log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result)
+{
+    if ((grid.cols() != u.cols()) || (grid != u)) {
+        prepare_grid(u);
+    }
+    result = factor_log_cf(0, T) + factor_log_cf(1, T);
+}
+
+std::pair<double, double> DoubleHestonModel::moment_strip(double T)
+{
+    std::pair<double, double> first = heston_critical_moments(T, params[0]);
+    std::pair<double, double> second = heston_critical_moments(T, params[1]);
+    return std::make_pair(std::max(first.first, second.first), std::min(first.second, second.second));
+}
+
+void DoubleHestonModel::set_params(int factor, const HestonParams &_params)
+{
+    check_factor(factor);
+    params[factor] = _params;
+    factor_cache[factor].clear();
+    if (grid.cols() > 0) {
+        prepare_factor(factor);
+    }
+}
+
+HestonParams DoubleHestonModel::get_params(int factor)
+{
+    check_factor(factor);
+    return params[factor];
+}
+
+void DoubleHestonModel::set_v0(int factor, double _v_0)
+{
+    check_factor(factor);
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0[factor] = _v_0;
+    factor_cache[factor].clear();
+}
+
+double DoubleHestonModel::get_v0(int factor)
+{
+    check_factor(factor);
+    return v_0[factor];
+}
+
+void DoubleHestonModel::clear_cache()
+{
+    grid.resize(0);
+    factor_cache[0].clear();
+    factor_cache[1].clear();
+}
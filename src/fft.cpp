@@ -4,6 +4,60 @@
  */
 #include "fft.h"
 
+/**
+ * @brief           Recursive radix-2 step of FFT
+ *
+ * @details         Transforms size elements of input taken with given stride into output.
+ *                  Even size is split into even and odd halves, odd size is transformed directly.
+ *
+ * @param   input       Pointer to the first input element
+ * @param   stride      Step between input elements
+ * @param   size        Count of elements to transform
+ * @param   output      Pointer to contiguous output of size elements
+ * @param   twiddles    Exponents \f$ e^{-2\pi ik/N} \f$ of the top level size N, k < N/2
+ * @param   twiddle_step    Step in twiddles table for current size, N/size
+ */
+static void fft_step(
+    const std::complex<double> *input,
+    int stride,
+    int size,
+    std::complex<double> *output,
+    const std::complex<double> *twiddles,
+    int twiddle_step
+) {
+    if (size % 2 == 1) {
+        // Direct DFT of odd size
+        for (int n=0; n<size; n++) {
+            std::complex<double> sum(0.0, 0.0);
+            for (int k=0; k<size; k++) {
+                sum += input[k * stride] * std::polar(1.0, -2 * M_PI * ((long long)n * k % size) / size);
+            }
+            output[n] = sum;
+        }
+        return;
+    }
+
+    // Transform even and odd elements, then combine by butterflies
+    int half_size = size >> 1;
+    fft_step(input, 2 * stride, half_size, output, twiddles, 2 * twiddle_step);
+    fft_step(input + stride, 2 * stride, half_size, output + half_size, twiddles, 2 * twiddle_step);
+    for (int n=0; n<half_size; n++) {
+        std::complex<double> even = output[n];
+        std::complex<double> odd = twiddles[n * twiddle_step] * output[n + half_size];
+        output[n] = even + odd;
+        output[n + half_size] = even - odd;
+    }
+}
+
+Eigen::RowVectorXcd fft_twiddles(int size)
+{
+    int half_size = size >> 1;
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd twiddles(half_size);
+    twiddles = (-2 * M_PI * i / (double)size) * Eigen::RowVectorXcd::LinSpaced(half_size, 0, half_size - 1);
+    return twiddles.array().exp();
+}
+
 Eigen::RowVectorXcd
 fft(Eigen::RowVectorXcd &vector)
 {
@@ -13,25 +67,93 @@ fft(Eigen::RowVectorXcd &vector)
     }
 
     // Result vector
-    Eigen::RowVectorXcd result(vector.cols());
-
-    // Calculate complex exponents
     int vector_size = vector.cols();
-    int half_size = vector.cols() >> 1;
-    std::complex<double> i(0.0, 1.0);
-    Eigen::RowVectorXcd exponents(half_size);
-    exponents = (-2 * M_PI * i / (double)half_size) * Eigen::RowVectorXcd::LinSpaced(half_size, 0, half_size - 1);
-    exponents = exponents.array().exp();
+    Eigen::RowVectorXcd result(vector_size);
+
+    // Calculate complex exponents once for all recursion levels
+    Eigen::RowVectorXcd twiddles = fft_twiddles(vector_size);
 
     // Calculate the spectrum
-    Eigen::RowVectorXcd even_half = vector(Eigen::seq(0, vector.cols() - 1, 2));
-    Eigen::RowVectorXcd odd_half  = vector(Eigen::seq(1, vector.cols() - 1, 2));
-    for (int n=0; n<vector_size; n++) {
-        Eigen::RowVectorXcd exp_pow = exponents.array().pow(n);
-        std::complex<double> dot_exponent = std::exp(-2 * M_PI * n * i / (double)vector_size); // multiplier
-        std::complex<double> sum_1 = exp_pow.cwiseProduct(even_half).sum();
-        std::complex<double> sum_2 = exp_pow.cwiseProduct(odd_half).sum();
-        result(n) = sum_1 + dot_exponent * sum_2;
+    if (vector_size > 0) {
+        fft_step(vector.data(), 1, vector_size, result.data(), twiddles.data(), 1);
+    }
+    return result;
+}
+
+void
+fft(const Eigen::RowVectorXcd &vector, const Eigen::RowVectorXcd &twiddles, Eigen::RowVectorXcd &result)
+{
+    int vector_size = vector.cols();
+    if (vector_size % 2 == 1) {
+        throw std::invalid_argument("Vector must be of even size.");
+    }
+    if ((result.cols() != vector_size) || (2 * twiddles.cols() != vector_size)) {
+        throw std::invalid_argument("Result and twiddles must be of vector size.");
+    }
+    if (vector_size > 0) {
+        fft_step(vector.data(), 1, vector_size, result.data(), twiddles.data(), 1);
+    }
+}
+
+Eigen::MatrixXcd
+fft(Eigen::MatrixXcd &matrix)
+{
+    // Check if length is even
+    if (matrix.cols() % 2 == 1) {
+        throw std::invalid_argument("Matrix rows must be of even size.");
+    }
+
+    // Result matrix and contiguous buffer for a row spectrum
+    int rows = matrix.rows();
+    int row_size = matrix.cols();
+    Eigen::MatrixXcd result(rows, row_size);
+    Eigen::RowVectorXcd spectrum(row_size);
+
+    // Complex exponents are shared by all rows
+    Eigen::RowVectorXcd twiddles = fft_twiddles(row_size);
+
+    // Column-major rows are strided by rows count
+    if (row_size > 0) {
+        for (int row=0; row<rows; row++) {
+            fft_step(matrix.data() + row, rows, row_size, spectrum.data(), twiddles.data(), 1);
+            result.row(row) = spectrum;
+        }
+    }
+    return result;
+}
+
+Eigen::RowVectorXcd
+goertzel(const Eigen::RowVectorXcd &vector, const Eigen::RowVectorXd &phases)
+{
+    int vector_size = vector.cols();
+    Eigen::RowVectorXcd result(phases.cols());
+    std::complex<double> i(0.0, 1.0);
+    for (int j=0; j<phases.cols(); j++) {
+        // Clenshaw recurrence b_n = f_n + 2cos(theta)b_{n+1} - b_{n+2}, sum is b_0 - e^{i theta}b_1
+        double theta = phases[j];
+        double half_sin = std::sin(theta / 2);
+        double half_cos = std::cos(theta / 2);
+        std::complex<double> b(0.0, 0.0);
+        std::complex<double> delta(0.0, 0.0);
+        if (std::cos(theta) >= 0) {
+            // delta_n = b_n - b_{n+1} = f_n - 4sin^2(theta/2)b_{n+1} + delta_{n+1}
+            double lambda = -4 * half_sin * half_sin;
+            for (int n=vector_size-1; n>=0; n--) {
+                delta = vector[n] + lambda * b + delta;
+                b = delta + b;
+            }
+            // b_0 - e^{i theta}b_1 = delta_0 + (1 - e^{i theta})b_1
+            result[j] = delta + (-2.0 * i * half_sin * std::exp(i * (theta / 2))) * (b - delta);
+        } else {
+            // delta_n = b_n + b_{n+1} = f_n + 4cos^2(theta/2)b_{n+1} - delta_{n+1}
+            double mu = 4 * half_cos * half_cos;
+            for (int n=vector_size-1; n>=0; n--) {
+                delta = vector[n] + mu * b - delta;
+                b = delta - b;
+            }
+            // b_0 - e^{i theta}b_1 = delta_0 - (1 + e^{i theta})b_1
+            result[j] = delta - (2.0 * half_cos * std::exp(i * (theta / 2))) * (delta - b);
+        }
     }
     return result;
-}
\ No newline at end of file
+}
@@ -0,0 +1,422 @@
+/**
+ * @file
+ * @brief Heston model calibration to market quotes.
+ */
+#include "heston_calibration.h"
+
+//! Differential evolution mutation factor and crossover probability.
+#define EVOLUTION_MUTATION 0.7
+#define EVOLUTION_CROSSOVER 0.9
+
+//! Relative spread of population residuals at which differential evolution stops.
+#define EVOLUTION_TOLERANCE 1e-6
+
+//! Relative decrease of residuals or relative step at which iterations stop.
+#define CALIBRATION_TOLERANCE 1e-6
+
+//! Lower and upper bounds of parameters (v_0, rho, kappa, theta, sigma).
+static const double lower_bounds[5] = {1e-4, -0.999, 1e-3, 1e-4, 1e-2};
+static const double upper_bounds[5] = {4.0, 0.999, 50.0, 4.0, 5.0};
+
+//! Lower and upper bounds of initial population of global search.
+static const double search_lower_bounds[5] = {1e-3, -0.99, 0.05, 1e-3, 0.05};
+static const double search_upper_bounds[5] = {0.5, 0.5, 10.0, 0.5, 2.0};
+
+HestonCalibrator::HestonCalibrator(
+    double _r,
+    double _s_0,
+    const std::vector<MarketQuote> &_quotes,
+    double _alpha,
+    int _N,
+    double _d_u
+) {
+    if (_r <= 0) {
+        throw std::invalid_argument("Risk-free rate must be non-negative.");
+    }
+    if (_s_0 <= 0) {
+        throw std::invalid_argument("Starting spot price must be non-negative.");
+    }
+    if (_quotes.empty()) {
+        throw std::invalid_argument("Quotes must be non-empty.");
+    }
+    r = _r; s_0 = _s_0; quotes = _quotes;
+    alpha = _alpha; N = _N; d_u = _d_u;
+    max_iterations = 100;
+    threads_count = std::max(1, (int)std::thread::hardware_concurrency());
+
+
+    // Carr-Madan parameteres are checked by calculator itself before the grid is used
+    HestonParams params = {0, 1, 1, 1};
+    HestonEuropeanOptionCalculator calculator(r, s_0, 1, params, alpha, N, d_u);
+
+    // Convert quotes to prices and group them by maturity
+    int size = quotes.size();
+    market_prices.resize(size);
+    sqrt_weights.resize(size);
+    std::map<double, std::vector<int> > groups;
+    for (int q=0; q<size; q++) {
+        MarketQuote &quote = quotes[q];
+        if ((quote.strike <= 0) || (quote.maturity <= 0) || (quote.value <= 0)) {
+            throw std::invalid_argument("Quote strike, maturity and value must be non-negative.");
+        }
+        if (quote.weight < 0) {
+            throw std::invalid_argument("Quote weight must be non-negative.");
+        }
+        market_prices[q] = quote.value;
+        if (quote.is_implied_volatility) {
+            market_prices[q] = black_scholes_price(quote.is_call, s_0, quote.strike, r, quote.maturity, quote.value);
+        }
+        sqrt_weights[q] = std::sqrt(quote.weight);
+        groups[quote.maturity].push_back(q);
+    }
+    for (std::map<double, std::vector<int> >::iterator group=groups.begin(); group!=groups.end(); group++) {
+        Eigen::RowVectorXd strikes(group->second.size());
+        for (int j=0; j<(int)group->second.size(); j++) {
+            strikes[j] = quotes[group->second[j]].strike;
+        }
+        maturities.push_back(group->first);
+        maturity_quotes.push_back(group->second);
+        maturity_strikes.push_back(strikes);
+
+        // Direct summation kernel exp(-i*n*d_u*k_j) of global search
+        Eigen::MatrixXd phases = Eigen::VectorXd::LinSpaced(N, 0, (N-1) * d_u) * strikes.array().log().matrix();
+        Eigen::MatrixXcd kernel(N, strikes.cols());
+        kernel.real() = phases.array().cos().matrix();
+        kernel.imag() = -phases.array().sin().matrix();
+        maturity_kernels.push_back(kernel);
+    }
+
+    // One calculator per maturity, iterations only update its parameteres
+    calculators.assign(maturities.size(), calculator);
+    set_strikes_evaluation(DIRECT_EVALUATION);
+    JumpParams no_jumps = {0, 0, 0, 0, 0};
+    set_jumps(no_jumps);
+}
+
+void HestonCalibrator::set_max_iterations(int _max_iterations)
+{
+    if (_max_iterations <= 0) {
+        throw std::invalid_argument("Iterations count must be non-negative.");
+    }
+    max_iterations = _max_iterations;
+}
+
+int HestonCalibrator::get_max_iterations()
+{
+    return max_iterations;
+}
+
+void HestonCalibrator::set_threads_count(int _threads_count)
+{
+    if (_threads_count <= 0) {
+        throw std::invalid_argument("Threads count must be non-negative.");
+    }
+    threads_count = _threads_count;
+}
+
+int HestonCalibrator::get_threads_count()
+{
+    return threads_count;
+}
+
+void HestonCalibrator::set_strikes_evaluation(StrikesEvaluation evaluation)
+{
+    strikes_evaluation = evaluation;
+    for (int index=0; index<(int)calculators.size(); index++) {
+        calculators[index].set_strikes_evaluation(evaluation);
+    }
+}
+
+StrikesEvaluation HestonCalibrator::get_strikes_evaluation()
+{
+    return strikes_evaluation;
+}
+
+void HestonCalibrator::set_jumps(const JumpParams &_jumps)
+{
+    check_jump_params(_jumps);
+    jumps = _jumps;
+    jump_transform.resize(0);
+    if (jumps.lambda > 0) {
+        jump_transform = jump_price_transform(carr_madan_arguments(alpha, N, d_u), jumps);
+    }
+    for (int index=0; index<(int)calculators.size(); index++) {
+        calculators[index].set_jumps(jumps, jump_transform);
+    }
+}
+
+JumpParams HestonCalibrator::get_jumps()
+{
+    return jumps;
+}
+
+Eigen::VectorXd HestonCalibrator::get_market_prices()
+{
+    return market_prices;
+}
+
+void HestonCalibrator::evaluate_maturity(
+    int index,
+    const Eigen::VectorXd &x,
+    Eigen::VectorXd &prices,
+    Eigen::MatrixXd &jacobian
+) {
+    HestonParams params = {x[1], x[2], x[3], x[4]};
+    HestonEuropeanOptionCalculator &calculator = calculators[index];
+    calculator.set_params(params);
+    calculator.set_v0(x[0]);
+    double T = maturities[index];
+    EuropeanOption option(true, T, s_0);
+
+    // Call prices and Jacobian at quotes strikes by one call
+    Eigen::RowVectorXd call_prices;
+    Eigen::MatrixXd quotes_jacobian = calculator.calculate_jacobian_at(option, maturity_strikes[index], call_prices);
+
+    // Put prices by Call-Put Parity, Jacobian is the same
+    const std::vector<int> &indices = maturity_quotes[index];
+    for (int j=0; j<(int)indices.size(); j++) {
+        MarketQuote &quote = quotes[indices[j]];
+        prices[indices[j]] = call_prices[j];
+        if (!quote.is_call) {
+            prices[indices[j]] += quote.strike * std::exp(-r * T) - s_0;
+        }
+        jacobian.row(indices[j]) = quotes_jacobian.row(j);
+    }
+}
+
+bool HestonCalibrator::evaluate(const Eigen::VectorXd &x, Eigen::VectorXd &residuals, Eigen::MatrixXd &jacobian)
+{
+    int size = quotes.size();
+    int maturities_count = maturities.size();
+    Eigen::VectorXd prices(size);
+    jacobian.resize(size, 5);
+
+    // Every thread prices its own maturities and writes their rows only
+    std::vector<char> failed(maturities_count, 0);
+    run_parallel(maturities_count, threads_count, [&](int index) {
+        try {
+            evaluate_maturity(index, x, prices, jacobian);
+        } catch (const std::invalid_argument &) {
+            failed[index] = 1;
+        }
+    });
+    for (int index=0; index<maturities_count; index++) {
+        if (failed[index]) {
+            return false;
+        }
+    }
+
+    residuals = sqrt_weights.cwiseProduct(prices - market_prices);
+    jacobian = sqrt_weights.asDiagonal() * jacobian;
+    return residuals.allFinite() && jacobian.allFinite();
+}
+
+void HestonCalibrator::evaluate_maturity_population(int index, const Eigen::MatrixXd &population, Eigen::MatrixXd &costs)
+{
+    double T = maturities[index];
+    EuropeanOption option(true, T, s_0);
+    const std::vector<int> &indices = maturity_quotes[index];
+
+    // Parity shift of put quotes, market prices and weights of the maturity
+    Eigen::RowVectorXd shift = Eigen::RowVectorXd::Zero(indices.size());
+    Eigen::RowVectorXd market(indices.size());
+    Eigen::RowVectorXd weights(indices.size());
+    for (int j=0; j<(int)indices.size(); j++) {
+        MarketQuote &quote = quotes[indices[j]];
+        if (!quote.is_call) {
+            shift[j] = quote.strike * std::exp(-r * T) - s_0;
+        }
+        market[j] = market_prices[indices[j]];
+        weights[j] = quote.weight;
+    }
+
+    // Parameter sets of population, members with infinite moments are not priced,
+    // as in HestonEuropeanOptionCalculator::integrate_condition()
+    int members = population.cols();
+    HestonParamsBatch batch(members);
+    Eigen::ArrayXd v = population.row(0).transpose();
+    Eigen::Array<bool, Eigen::Dynamic, 1> valid(members);
+    for (int member=0; member<members; member++) {
+        HestonParams params = {population(1, member), population(2, member), population(3, member), population(4, member)};
+        batch.set(member, params);
+        valid[member] = heston_moment_explosion_time(alpha + 1, params) > T;
+        if (valid[member] && (jumps.lambda > 0) && (jumps.mu_v > 0)) {
+            valid[member] = svjj_moment_finite(alpha + 1, T, params, jumps);
+        }
+    }
+
+    // Carr-Madan integrand of all members by batch char. function at w = u - (alpha + 1)i
+    Eigen::RowVectorXcd w = carr_madan_arguments(alpha, N, d_u);
+    Eigen::MatrixXcd integrands = heston_log_price_cf(w, std::log(s_0) + r * T, v, 0, T, batch);
+
+    // Jumps factor, Bates one is the same for all members
+    if (jumps.lambda > 0) {
+        Eigen::RowVectorXcd J;
+        for (int member=0; member<members; member++) {
+            if ((member == 0) || (jumps.mu_v > 0)) {
+                HestonParams params = batch.get(member);
+                svjj_jump_coefficient(w, T, params, jumps, jump_transform, J);
+                J = J.array().exp().matrix();
+            }
+            integrands.row(member) = integrands.row(member).cwiseProduct(J);
+        }
+    }
+    integrands = (integrands.array().rowwise() * carr_madan_weights(alpha, N, d_u).array()).matrix();
+
+    // Direct summation of all members at once
+    Eigen::RowVectorXd factor = std::exp(-r * T) * carr_madan_damping(
+        alpha, d_u, maturity_strikes[index].array().log().matrix()
+    );
+    Eigen::MatrixXd prices = (integrands * maturity_kernels[index]).real() * factor.asDiagonal();
+    Eigen::MatrixXd residuals = (prices.rowwise() + (shift - market)).cwiseAbs2();
+    Eigen::VectorXd sums = residuals * weights.transpose();
+    for (int member=0; member<members; member++) {
+        costs(index, member) = valid[member] ? sums[member] : std::numeric_limits<double>::infinity();
+    }
+}
+
+Eigen::VectorXd HestonCalibrator::evaluate_population(const Eigen::MatrixXd &population)
+{
+    // Every thread prices all members for its own maturities
+    Eigen::MatrixXd costs(maturities.size(), population.cols());
+    run_parallel(maturities.size(), threads_count, [&](int index) {
+        evaluate_maturity_population(index, population, costs);
+    });
+
+    Eigen::VectorXd result = costs.colwise().sum().transpose();
+    for (int member=0; member<result.rows(); member++) {
+        if (!std::isfinite(result[member])) {
+            result[member] = std::numeric_limits<double>::infinity();
+        }
+    }
+    return result;
+}
+
+CalibrationResult HestonCalibrator::calibrate(HestonParams &params, double v_0)
+{
+    Eigen::VectorXd x(5);
+    x << v_0, params.rho, params.kappa, params.theta, params.sigma;
+    Eigen::VectorXd lower = Eigen::Map<const Eigen::VectorXd>(lower_bounds, 5);
+    Eigen::VectorXd upper = Eigen::Map<const Eigen::VectorXd>(upper_bounds, 5);
+    x = x.cwiseMax(lower).cwiseMin(upper);
+
+    Eigen::VectorXd residuals;
+    Eigen::MatrixXd jacobian;
+    if (!evaluate(x, residuals, jacobian)) {
+        throw std::invalid_argument("Initial parameteres could not be priced.");
+    }
+    double cost = residuals.squaredNorm();
+    // Start close to gradient descent, initial guesses are usually far from optimum
+    double lambda = 10;
+
+    int iteration = 0;
+    while (iteration < max_iterations) {
+        iteration++;
+
+        // Damped normal equations with Marquardt scaling
+        Eigen::MatrixXd normal = jacobian.transpose() * jacobian;
+        Eigen::VectorXd gradient = jacobian.transpose() * residuals;
+        Eigen::MatrixXd damped = normal;
+        damped.diagonal() += lambda * (normal.diagonal().array() + 1e-12).matrix();
+        Eigen::VectorXd x_new = (x - damped.ldlt().solve(gradient)).cwiseMax(lower).cwiseMin(upper);
+
+        Eigen::VectorXd residuals_new;
+        Eigen::MatrixXd jacobian_new;
+        if (evaluate(x_new, residuals_new, jacobian_new) && (residuals_new.squaredNorm() < cost)) {
+            double cost_new = residuals_new.squaredNorm();
+            bool converged = ((cost - cost_new) < CALIBRATION_TOLERANCE * cost) ||
+                ((x_new - x).norm() < CALIBRATION_TOLERANCE * x.norm());
+            x = x_new; residuals = residuals_new; jacobian = jacobian_new; cost = cost_new;
+            lambda = std::max(lambda / 3, 1e-12);
+            if (converged) {
+                break;
+            }
+        } else {
+            // Rejected step, move towards gradient descent
+            lambda *= 4;
+            if (lambda > 1e12) {
+                break;
+            }
+        }
+    }
+
+    CalibrationResult result;
+    result.params.rho = x[1];
+    result.params.kappa = x[2];
+    result.params.theta = x[3];
+    result.params.sigma = x[4];
+    result.v_0 = x[0];
+    result.rmse = std::sqrt(cost / quotes.size());
+    result.iterations = iteration;
+    return result;
+}
+
+CalibrationResult HestonCalibrator::calibrate_global(int population_size, int generations, unsigned int seed)
+{
+    if (population_size < 4) {
+        throw std::invalid_argument("Population size must be not less than 4.");
+    }
+    if (generations < 0) {
+        throw std::invalid_argument("Generations count must be non-negative.");
+    }
+    Eigen::VectorXd lower = Eigen::Map<const Eigen::VectorXd>(lower_bounds, 5);
+    Eigen::VectorXd upper = Eigen::Map<const Eigen::VectorXd>(upper_bounds, 5);
+    Eigen::VectorXd search_lower = Eigen::Map<const Eigen::VectorXd>(search_lower_bounds, 5);
+    Eigen::VectorXd search_upper = Eigen::Map<const Eigen::VectorXd>(search_upper_bounds, 5);
+
+    // Uniform initial population inside search bounds
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<int> pick(0, population_size - 1);
+    Eigen::MatrixXd population(5, population_size);
+    for (int member=0; member<population_size; member++) {
+        for (int p=0; p<5; p++) {
+            population(p, member) = search_lower[p] + uniform(generator) * (search_upper[p] - search_lower[p]);
+        }
+    }
+    Eigen::VectorXd costs = evaluate_population(population);
+
+    for (int generation=0; generation<generations; generation++) {
+        // DE/rand/1/bin trial vectors
+        Eigen::MatrixXd trials(5, population_size);
+        for (int member=0; member<population_size; member++) {
+            int a, b, c;
+            do { a = pick(generator); } while (a == member);
+            do { b = pick(generator); } while ((b == member) || (b == a));
+            do { c = pick(generator); } while ((c == member) || (c == a) || (c == b));
+            Eigen::VectorXd mutant = population.col(a) + EVOLUTION_MUTATION * (population.col(b) - population.col(c));
+            int forced = pick(generator) % 5;
+            for (int p=0; p<5; p++) {
+                bool crossover = (p == forced) || (uniform(generator) < EVOLUTION_CROSSOVER);
+                trials(p, member) = crossover ? mutant[p] : population(p, member);
+            }
+            trials.col(member) = trials.col(member).cwiseMax(lower).cwiseMin(upper);
+        }
+
+        // Greedy selection
+        Eigen::VectorXd trial_costs = evaluate_population(trials);
+        for (int member=0; member<population_size; member++) {
+            if (trial_costs[member] <= costs[member]) {
+                population.col(member) = trials.col(member);
+                costs[member] = trial_costs[member];
+            }
+        }
+
+        // Stop when the whole population lies in one basin
+        double best = costs.minCoeff();
+        double worst = costs.maxCoeff();
+        if (std::isfinite(worst) && (worst - best <= EVOLUTION_TOLERANCE * worst)) {
+            break;
+        }
+    }
+
+    // Polish the best member by Levenberg-Marquardt method
+    int best_member;
+    costs.minCoeff(&best_member);
+    if (!std::isfinite(costs[best_member])) {
+        throw std::invalid_argument("No parameteres of population could be priced.");
+    }
+    Eigen::VectorXd x = population.col(best_member);
+    HestonParams params = {x[1], x[2], x[3], x[4]};
+    return calibrate(params, x[0]);
+}
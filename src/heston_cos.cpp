@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @brief Class of european options Heston model calculator by COS method.
+ */
+#include "heston_cos.h"
+
+HestonCosCalculator::HestonCosCalculator(
+    double _r,
+    double _s_0,
+    double _v_0,
+    HestonParams &_params,
+    int N,
+    double L
+) {
+    if (_r <= 0) {
+        throw std::invalid_argument("Risk-free rate must be non-negative.");
+    }
+    if (_s_0 <= 0) {
+        throw std::invalid_argument("Starting spot price must be non-negative.");
+    }
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    r = _r; s_0 = _s_0; v_0 = _v_0; params = _params;
+    set_calculator_params(N, L);
+}
+
+double HestonCosCalculator::df(double t, double T)
+{
+    return std::exp(-r * (T-t));
+}
+
+void HestonCosCalculator::set_calculator_params(int _N, double _L)
+{
+    if (_N <= 0) {
+        throw std::invalid_argument("Series terms count must be non-negative.");
+    }
+    if (_L <= 0) {
+        throw std::invalid_argument("Truncation range width must be non-negative.");
+    }
+    N = _N;
+    L = _L;
+}
+
+int HestonCosCalculator::get_N()
+{
+    return N;
+}
+
+double HestonCosCalculator::get_L()
+{
+    return L;
+}
+
+/**
+ * @brief           Right-hand side of Riccati ODE for Taylor coefficients of C, D at iu = 0
+ *
+ * @details         Coefficients solve the Heston Riccati ODE order by order:
+ *                  \f$ D_n' = -\kappa D_n + \rho\sigma D_{n-1} + \frac{\sigma^2}{2}\sum_{j+k=n} D_jD_k + s_n \f$,
+ *                  \f$ C_n' = \kappa\theta D_n \f$, where \f$ s_1 = -1/2, s_2 = 1/2 \f$.
+ *
+ * @param   y       State \f$ (D_1,..,D_4,C_1,..,C_4) \f$
+ * @param   params  Heston model parameters struct
+ */
+static Eigen::Matrix<double, 8, 1> cumulants_rhs(const Eigen::Matrix<double, 8, 1> &y, HestonParams &params)
+{
+    double kappa = params.kappa;
+    double rho_sigma = params.rho * params.sigma;
+    double half_sigma_2 = params.sigma * params.sigma / 2;
+    Eigen::Matrix<double, 8, 1> dy;
+    dy[0] = -kappa * y[0] - 0.5;
+    dy[1] = -kappa * y[1] + rho_sigma * y[0] + half_sigma_2 * y[0] * y[0] + 0.5;
+    dy[2] = -kappa * y[2] + rho_sigma * y[1] + half_sigma_2 * 2 * y[0] * y[1];
+    dy[3] = -kappa * y[3] + rho_sigma * y[2] + half_sigma_2 * (2 * y[0] * y[2] + y[1] * y[1]);
+    dy.tail(4) = (kappa * params.theta) * y.head(4);
+    return dy;
+}
+
+Eigen::Vector4d HestonCosCalculator::get_cumulants(double T)
+{
+    // Integrate Taylor coefficients of C, D by RK4, step is small w.r.t. mean-reversion time
+    int steps = 64 + (int)std::ceil(40 * params.kappa * T);
+    double h = T / steps;
+    Eigen::Matrix<double, 8, 1> y = Eigen::Matrix<double, 8, 1>::Zero();
+    for (int step=0; step<steps; step++) {
+        Eigen::Matrix<double, 8, 1> k_1 = cumulants_rhs(y, params);
+        Eigen::Matrix<double, 8, 1> k_2 = cumulants_rhs(y + h / 2 * k_1, params);
+        Eigen::Matrix<double, 8, 1> k_3 = cumulants_rhs(y + h / 2 * k_2, params);
+        Eigen::Matrix<double, 8, 1> k_4 = cumulants_rhs(y + h * k_3, params);
+        y += (h / 6) * (k_1 + 2 * k_2 + 2 * k_3 + k_4);
+    }
+
+    // n-th cumulant is n! times the Taylor coefficient of C + D*v_0
+    Eigen::Vector4d factorials(1, 2, 6, 24);
+    return factorials.cwiseProduct(y.tail(4) + v_0 * y.head(4));
+}
+
+std::pair<double, double> HestonCosCalculator::get_truncation_range(double T)
+{
+    Eigen::Vector4d c = get_cumulants(T);
+    double width = L * std::sqrt(std::abs(c[1]) + std::sqrt(std::abs(c[3])));
+    return std::pair<double, double>(c[0] - width, c[0] + width);
+}
+
+Eigen::RowVectorXd HestonCosCalculator::calculate(EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    double T = option.get_maturity();
+    double F = s_0 / df(0, T);
+    std::pair<double, double> range = get_truncation_range(T);
+    double a = range.first;
+    double b = range.second;
+
+    // Series frequencies u_k = k*pi/(b-a) and char. function of ln(S_T/F_0)
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXd u = Eigen::RowVectorXd::LinSpaced(N, 0, (N - 1) * M_PI / (b - a));
+    Eigen::RowVectorXcd cf = heston_log_price_cf(u.cast<std::complex<double> >(), 0, v_0, 0, T, params);
+
+    // Strike independent weights Re[phi(u_k)exp(-iu_k a)], first term is halved
+    Eigen::RowVectorXd weights = (cf.array() * (-i * a * u.array()).exp()).real();
+    weights[0] *= 0.5;
+
+    // Put payoff (K - F e^z)^+ is non-zero on [a, c], where c = min(ln(K/F), b)
+    Eigen::ArrayXd c = (strikes.array() / F).log().min(b).transpose();
+    c = c.max(a);
+    Eigen::ArrayXd exp_c = c.exp();
+    Eigen::ArrayXXd phase = (c - a).matrix() * u;
+    Eigen::ArrayXXd sin_phase = phase.sin();
+    Eigen::ArrayXXd cos_phase = phase.cos();
+
+    // Cosine coefficients chi_k(a,c) of e^z and psi_k(a,c) of 1
+    Eigen::ArrayXXd chi = (
+        cos_phase.colwise() * exp_c - std::exp(a) +
+        (sin_phase.rowwise() * u.array()).colwise() * exp_c
+    ).rowwise() / (1 + u.array().square());
+    Eigen::ArrayXXd psi(strikes.cols(), N);
+    psi.col(0) = c - a;
+    psi.rightCols(N - 1) = sin_phase.rightCols(N - 1).rowwise() / u.array().tail(N - 1);
+
+    // Put payoff coefficients for every strike
+    Eigen::MatrixXd payoff = (2 / (b - a)) * (
+        psi.colwise() * strikes.array().transpose() - F * chi
+    ).matrix();
+
+    // Put prices by a single matrix-vector product
+    Eigen::RowVectorXd result = df(0, T) * (payoff * weights.transpose()).transpose();
+
+    if (!option.is_call()) {
+        return result;
+    }
+
+    // If option is of call type, use the Put-Call parity
+    return result.array() + s_0 - strikes.array() * df(0, T);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Heston-Hull-White (H1-HW) stochastic rates model policy of FourierPricer.
+ */
+#include "heston_hull_white.h"
+
+//! Gauss-Legendre nodes count of rates variance integral.
+#define RATES_QUADRATURE_NODES 32
+
+//! Noncentrality of variance distribution above which its expected square root is found by delta method.
+#define NONCENTRALITY_THRESHOLD 1e3
+
+//! Half width of Poisson weights summed in series of expected square root, in standard deviations.
+#define POISSON_WIDTH 12.0
+
+void check_hull_white_params(const HullWhiteParams &rates)
+{
+    if (rates.lambda <= 0) {
+        throw std::invalid_argument("Short rate mean reversion must be non-negative.");
+    }
+    if (rates.eta <= 0) {
+        throw std::invalid_argument("Short rate volatility must be non-negative.");
+    }
+    if ((rates.rho < -1) || (rates.rho > 1)) {
+        throw std::invalid_argument("Correlation of stock and short rate must be in [-1, 1].");
+    }
+}
+
+HestonHullWhiteModel::HestonHullWhiteModel(const HestonParams &_params, double _v_0, const HullWhiteParams &_rates)
+{
+    gauss_legendre(RATES_QUADRATURE_NODES, nodes, weights);
+    set_params(_params);
+    set_v0(_v_0);
+    set_rates(_rates);
+}
+
+double HestonHullWhiteModel::expected_volatility(double t)
+{
+    if (t <= 0) {
+        return std::sqrt(v_0);
+    }
+
+    // v(t) = c * X, X is noncentral chi-squared with delta degrees of freedom and noncentrality l
+    double exp_kappa = std::exp(-params.kappa * t);
+    double c = params.sigma * params.sigma * (1 - exp_kappa) / (4 * params.kappa);
+    double delta = 4 * params.kappa * params.theta / (params.sigma * params.sigma);
+    double l = v_0 * exp_kappa / c;
+    if (l > NONCENTRALITY_THRESHOLD) {
+        double mean = c * (delta + l);
+        double variance = 2 * c * c * (delta + 2 * l);
+        return std::sqrt(mean) * (1 - variance / (8 * mean * mean));
+    }
+
+    // Poisson mixture of central ones: E sqrt(X) = sqrt(2) sum P(k) Gamma((delta + 1)/2 + k) / Gamma(delta/2 + k)
+    double half = 0.5 * l;
+    int first = (int)std::max(0.0, std::floor(half - POISSON_WIDTH * (std::sqrt(half) + 1)));
+    int last = (int)std::ceil(half + POISSON_WIDTH * (std::sqrt(half) + 1));
+    double sum = 0;
+    for (int k=first; k<=last; k++) {
+        sum += std::exp(
+            -half + k * std::log(half) - std::lgamma(k + 1.0)
+            + std::lgamma(0.5 * (delta + 1) + k) - std::lgamma(0.5 * delta + k)
+        );
+    }
+    return std::sqrt(2 * c) * sum;
+}
+
+double HestonHullWhiteModel::rates_variance(double T)
+{
+    double *cached = variance_cache.find(T);
+    if (cached != NULL) {
+        return *cached;
+    }
+
+    // Integral of B^2 in closed form, cross term by Gauss-Legendre rule on [0, T]
+    double lambda = rates.lambda;
+    double exp_lambda = std::exp(-lambda * T);
+    double squares = (T - 2 * (1 - exp_lambda) / lambda + (1 - exp_lambda * exp_lambda) / (2 * lambda)) / (lambda * lambda);
+    double cross = 0;
+    for (int j=0; j<nodes.cols(); j++) {
+        double t = 0.5 * T * (1 + nodes[j]);
+        double B = (std::exp(-lambda * (T - t)) - 1) / lambda;
+        cross += weights[j] * B * expected_volatility(t);
+    }
+    cross *= 0.5 * T;
+
+    double result = rates.eta * rates.eta * squares - 2 * rates.rho * rates.eta * cross;
+    variance_cache.insert(T, result);
+    return result;
+}
+
+void HestonHullWhiteModel::log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result)
+{
+    std::complex<double> i(0.0, 1.0);
+    heston_cf_coefficients(u, T, params, C, D);
+    result = (
+        C.array() + v_0 * D.array() - (0.5 * rates_variance(T)) * (i * u.array() + u.array().square())
+    ).matrix();
+}
+
+std::pair<double, double> HestonHullWhiteModel::moment_strip(double T)
+{
+    return heston_critical_moments(T, params);
+}
+
+void HestonHullWhiteModel::set_params(const HestonParams &_params)
+{
+    params = _params;
+    variance_cache.clear();
+}
+
+HestonParams HestonHullWhiteModel::get_params()
+{
+    return params;
+}
+
+void HestonHullWhiteModel::set_v0(double _v_0)
+{
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0 = _v_0;
+    variance_cache.clear();
+}
+
+double HestonHullWhiteModel::get_v0()
+{
+    return v_0;
+}
+
+void HestonHullWhiteModel::set_rates(const HullWhiteParams &_rates)
+{
+    check_hull_white_params(_rates);
+    rates = _rates;
+    variance_cache.clear();
+}
+
+HullWhiteParams HestonHullWhiteModel::get_rates()
+{
+    return rates;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @brief Class of european options Heston model calculator by Lewis formula.
+ */
+#include "heston_lewis.h"
+
+HestonLewisCalculator::HestonLewisCalculator(
+    double _r,
+    double _s_0,
+    double _v_0,
+    HestonParams &_params,
+    int N
+) {
+    if (_r <= 0) {
+        throw std::invalid_argument("Risk-free rate must be non-negative.");
+    }
+    if (_s_0 <= 0) {
+        throw std::invalid_argument("Starting spot price must be non-negative.");
+    }
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    r = _r; s_0 = _s_0; v_0 = _v_0; params = _params;
+    set_calculator_params(N);
+}
+
+double HestonLewisCalculator::df(double t, double T)
+{
+    return std::exp(-r * (T-t));
+}
+
+void HestonLewisCalculator::set_calculator_params(int _N)
+{
+    gauss_laguerre(_N, nodes, weights);
+    N = _N;
+    cached_T = 0;
+}
+
+int HestonLewisCalculator::get_N()
+{
+    return N;
+}
+
+double HestonLewisCalculator::get_node_scale(double T)
+{
+    // For long maturities char. function decays as exp(-c*u), nodes are contracted to match it
+    double c = std::sqrt(1 - params.rho * params.rho) * (v_0 + params.kappa * params.theta * T) / params.sigma;
+    return std::min(1.0, 1 / c);
+}
+
+void HestonLewisCalculator::prepare(double T)
+{
+    if (T == cached_T) {
+        return;
+    }
+
+    // Black-Scholes control variate with expected average variance over [0, T]
+    double e_1 = std::exp(-params.kappa * T);
+    cached_variance = params.theta + (v_0 - params.theta) * (1 - e_1) / (params.kappa * T);
+
+    double scale = get_node_scale(T);
+    cached_u = scale * nodes;
+
+    // Integrand phi_BS(u - i/2) - phi(u - i/2) has no poles at u = +-i/2
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd shifted = cached_u.cast<std::complex<double> >().array() - 0.5 * i;
+    Eigen::RowVectorXcd cf = heston_log_price_cf(shifted, 0, v_0, 0, T, params);
+    Eigen::RowVectorXcd cf_bs = (
+        (-0.5 * cached_variance * T) * (i * shifted.array() + shifted.array().square())
+    ).exp().matrix();
+    cached_integrand = (
+        (cf_bs - cf).array() * (scale * weights.array() / (cached_u.array().square() + 0.25))
+    ).matrix();
+    cached_T = T;
+}
+
+Eigen::RowVectorXd HestonLewisCalculator::calculate(EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    double T = option.get_maturity();
+    prepare(T);
+    double F = s_0 / df(0, T);
+
+    // Re[e^{iuk}h(u)] = cos(uk)Re[h] - sin(uk)Im[h], a dot product per strike
+    Eigen::ArrayXd log_moneyness = (F / strikes.array()).log().transpose();
+    Eigen::ArrayXXd phase = log_moneyness.matrix() * cached_u;
+    Eigen::VectorXd integral =
+        phase.cos().matrix() * cached_integrand.real().transpose() -
+        phase.sin().matrix() * cached_integrand.imag().transpose();
+
+    // Black-Scholes control variate call prices
+    double sd = std::sqrt(cached_variance * T);
+    Eigen::ArrayXd d_1 = log_moneyness / sd + sd / 2;
+    Eigen::ArrayXd d_2 = d_1 - sd;
+    Eigen::ArrayXd K = strikes.array().transpose();
+    Eigen::ArrayXd call_bs = df(0, T) * (
+        F * d_1.unaryExpr(&normal_cdf) - K * d_2.unaryExpr(&normal_cdf)
+    );
+
+    Eigen::RowVectorXd result = (
+        call_bs + (df(0, T) / M_PI) * (F * K).sqrt() * integral.array()
+    ).transpose();
+
+    if (option.is_call()) {
+        return result;
+    }
+
+    // If option is of put type, use the Put-Call parity
+    return result.array() + strikes.array() * df(0, T) - s_0;
+}
+
+double HestonLewisCalculator::calculate(EuropeanOption &option)
+{
+    Eigen::RowVectorXd strikes(1);
+    strikes[0] = option.get_strike();
+    return calculate(option, strikes)[0];
+}
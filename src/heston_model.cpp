@@ -4,6 +4,118 @@
  */
 #include "heston_model.h"
 
+#include <cfloat>
+
+//! Count of elements of blocks processed by batch char. function kernels.
+#define CF_BATCH_BLOCK_SIZE 256
+
+//! Adding and subtracting 1.5*2^52 rounds doubles to the nearest integer.
+#define ROUNDING_SHIFT 6755399441055744.0
+
+//! Largest moment order searched for critical moments.
+#define MAX_MOMENT_ORDER 1e6
+
+//! Bisection iterations count of critical moments.
+#define CRITICAL_MOMENT_ITERATIONS 100
+
+//! Modulus below which variance jumps integral is expanded at its removable singularity.
+#define JUMP_SINGULARITY_TOLERANCE 1e-8
+
+/**
+ * @brief           Round array elements to the nearest integers by packet arithmetic
+ */
+static Eigen::ArrayXXd round_nearest(const Eigen::ArrayXXd &x)
+{
+    return (x + ROUNDING_SHIFT) - ROUNDING_SHIFT;
+}
+
+/**
+ * @brief           Get signs of array elements by packet arithmetic, sign of zero is 1
+ */
+static Eigen::ArrayXXd unit_sign(const Eigen::ArrayXXd &x)
+{
+    Eigen::ArrayXXd sign = x / x.abs().max(DBL_MIN);
+    return sign + 1 - sign.abs();
+}
+
+/**
+ * @brief           Calculate sine and cosine of array elements by packet arithmetic
+ *
+ * @details         Eigen has no packet sine and cosine of doubles. Argument is reduced to \f$ |r|\leq\pi/4 \f$
+ *                  by two-term Cody-Waite split of \f$ \pi/2 \f$, then Cephes polynomials are used,
+ *                  so relative error is about machine epsilon for \f$ |x| < 10^6 \f$.
+ *                  Quadrant is restored arithmetically, since Eigen selects are scalar branches.
+ */
+static void sin_cos(const Eigen::ArrayXXd &x, Eigen::ArrayXXd &sine, Eigen::ArrayXXd &cosine)
+{
+    Eigen::ArrayXXd k = round_nearest(x * M_2_PI);
+    Eigen::ArrayXXd r = (x - k * 1.57079632673412561417e+00) - k * 6.07710050650619224932e-11;
+    Eigen::ArrayXXd z = r.square();
+    Eigen::ArrayXXd s = r + r * z * (-1.66666666666666307295e-1 + z * (8.33333333332211858878e-3 +
+        z * (-1.98412698295895385996e-4 + z * (2.75573136213857245213e-6 +
+        z * (-2.50507477628578072866e-8 + z * 1.58962301576546568060e-10)))));
+    Eigen::ArrayXXd c = 1.0 - 0.5 * z + z.square() * (4.16666666666665929218e-2 + z * (-1.38888888888730564116e-3 +
+        z * (2.48015872888517045348e-5 + z * (-2.75573141792967388112e-7 +
+        z * (2.08757008419747316778e-9 + z * -1.13585365213876817300e-11)))));
+
+    // Quadrant q = k mod 4 = 2h + p, floors are rounded without ties
+    Eigen::ArrayXXd q = k - 4 * round_nearest(0.25 * k - 0.375);
+    Eigen::ArrayXXd h = round_nearest(0.5 * q - 0.25);
+    Eigen::ArrayXXd p = q - 2 * h;
+
+    // Odd quadrants swap sine and cosine, signs are (+,+), (+,-), (-,-), (-,+)
+    sine = (1 - 2 * h) * (s + p * (c - s));
+    cosine = (1 - 2 * (p + h - 2 * p * h)) * (c + p * (s - c));
+}
+
+/**
+ * @brief           Calculate argument \f$ \mathrm{atan2}(y, x) \f$ of array elements by packet arithmetic
+ *
+ * @details         Half-angle formula \f$ \arg z = 2\arctan\frac{y}{|z| + |x|} \f$ (for \f$ x\geq0 \f$)
+ *                  is applied twice to reduce arctangent argument to \f$ |t|\leq\tan\frac{\pi}{8} \f$,
+ *                  where Cephes rational approximation is used. Left half-plane is reflected arithmetically.
+ */
+static Eigen::ArrayXXd argument(const Eigen::ArrayXXd &y, const Eigen::ArrayXXd &x)
+{
+    Eigen::ArrayXXd a = x.abs();
+    Eigen::ArrayXXd t = y / ((x.square() + y.square()).sqrt() + a).max(DBL_MIN);
+    t /= 1 + (1 + t.square()).sqrt();
+    Eigen::ArrayXXd z = t.square();
+    Eigen::ArrayXXd p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z -
+        7.500855792314704667340e1) * z - 1.228866684490136173410e2) * z - 6.485021904942025371773e1;
+    Eigen::ArrayXXd q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z +
+        4.328810604912902668951e2) * z + 4.853903996359136964868e2) * z + 1.945506571482613964425e2;
+    Eigen::ArrayXXd angle = 4 * (t + t * z * p / q);
+
+    // arg z = sign(y)*pi - arg(-x + iy) for x < 0, weight of reflection is 1/2 at x = 0
+    Eigen::ArrayXXd left = 0.5 - 0.5 * x / a.max(DBL_MIN);
+    return angle + left * (M_PI * unit_sign(y) - 2 * angle);
+}
+
+HestonParamsBatch::HestonParamsBatch(int size)
+    : rho(size), kappa(size), theta(size), sigma(size)
+{
+}
+
+int HestonParamsBatch::size() const
+{
+    return rho.rows();
+}
+
+void HestonParamsBatch::set(int index, const HestonParams &params)
+{
+    rho[index] = params.rho;
+    kappa[index] = params.kappa;
+    theta[index] = params.theta;
+    sigma[index] = params.sigma;
+}
+
+HestonParams HestonParamsBatch::get(int index) const
+{
+    HestonParams params = {rho[index], kappa[index], theta[index], sigma[index]};
+    return params;
+}
+
 std::complex<double>
 heston_log_price_cf(std::complex<double> u, double x, double v, double t, double T, HestonParams &params)
 {
@@ -37,3 +149,606 @@ heston_exp_option_cf(std::complex<double> u, double x, double v, double alpha, d
         heston_log_price_cf(u - (alpha + one) * i, x, v, 0, T, params) / 
         (std::pow(alpha, 2) + alpha - std::pow(u, 2) + i * (two * alpha + one) * u);
 }
+
+double heston_moment_explosion_time(double omega, HestonParams &params)
+{
+    return heston_riccati_explosion_time(omega, 0, params);
+}
+
+double heston_riccati_explosion_time(double omega, double D_0, HestonParams &params)
+{
+    double b = params.rho * params.sigma * omega - params.kappa;
+    double discriminant = b * b - params.sigma * params.sigma * omega * (omega - 1);
+    double shifted = b + params.sigma * params.sigma * D_0;
+    if (discriminant >= 0) {
+        double gamma = std::sqrt(discriminant);
+        if (shifted <= gamma) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return std::log((shifted + gamma) / (shifted - gamma)) / gamma;
+    }
+    double gamma = std::sqrt(-discriminant);
+    return 2 * ((shifted < 0 ? M_PI : 0) + std::atan(gamma / shifted)) / gamma;
+}
+
+double heston_riccati_moment_solution(double omega, double D_0, double tau, HestonParams &params)
+{
+    // D = -(b + (Delta*s - b'*c)/(c - b'*s))/sigma^2 with c = cosh(gamma*tau/2), s = sinh(gamma*tau/2)/gamma,
+    // both are scaled by exp(-gamma*tau/2) if Delta > 0
+    double b = params.rho * params.sigma * omega - params.kappa;
+    double sigma_2 = params.sigma * params.sigma;
+    double discriminant = b * b - sigma_2 * omega * (omega - 1);
+    double shifted = b + sigma_2 * D_0;
+    double c, s;
+    if (discriminant > 0) {
+        double gamma = std::sqrt(discriminant);
+        double decay = std::exp(-gamma * tau);
+        c = 0.5 * (1 + decay);
+        s = 0.5 * (1 - decay) / gamma;
+    } else if (discriminant < 0) {
+        double gamma = std::sqrt(-discriminant);
+        c = std::cos(0.5 * gamma * tau);
+        s = std::sin(0.5 * gamma * tau) / gamma;
+    } else {
+        c = 1;
+        s = 0.5 * tau;
+    }
+    return -(b + (discriminant * s - shifted * c) / (c - shifted * s)) / sigma_2;
+}
+
+/**
+ * @brief           Find moment order where moments become infinite between finite and exploded orders
+ *
+ * @param   is_finite   Predicate of moment order, whether moment is finite
+ */
+template <typename Predicate>
+static double critical_moment(double finite, double exploded, Predicate is_finite)
+{
+    for (int iteration=0; iteration<CRITICAL_MOMENT_ITERATIONS; iteration++) {
+        double middle = 0.5 * (finite + exploded);
+        if (is_finite(middle)) {
+            finite = middle;
+        } else {
+            exploded = middle;
+        }
+    }
+    return 0.5 * (finite + exploded);
+}
+
+/**
+ * @brief           Find critical moments of an interval of finite moments containing [0, 1]
+ *
+ * @param   is_finite   Predicate of moment order, whether moment is finite
+ */
+template <typename Predicate>
+static std::pair<double, double> critical_moments(Predicate is_finite)
+{
+    std::pair<double, double> result(
+        -std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity()
+    );
+
+    // Double moment orders outside of [0, 1] until moment is infinite
+    for (double omega=2; omega<=MAX_MOMENT_ORDER; omega*=2) {
+        if (!is_finite(omega)) {
+            result.second = critical_moment(omega / 2, omega, is_finite);
+            break;
+        }
+    }
+    for (double omega=-1; omega>=-MAX_MOMENT_ORDER; omega*=2) {
+        if (!is_finite(omega)) {
+            result.first = critical_moment(omega == -1 ? 0 : omega / 2, omega, is_finite);
+            break;
+        }
+    }
+    return result;
+}
+
+std::pair<double, double> heston_critical_moments(double T, HestonParams &params)
+{
+    return critical_moments([&](double omega) {
+        return heston_moment_explosion_time(omega, params) > T;
+    });
+}
+
+bool piecewise_heston_moment_finite(
+    double omega,
+    double T,
+    std::vector<double> &times,
+    std::vector<HestonParams> &params
+) {
+    // Backward recursion from T: every interval starts at D of the later one and must be shorter than
+    // explosion time of its Riccati equation
+    int interval = std::lower_bound(times.begin(), times.end(), T) - times.begin();
+    double D = 0, end = T;
+    for (int j=interval; j>=0; j--) {
+        double start = (j > 0) ? times[j - 1] : 0;
+        if (heston_riccati_explosion_time(omega, D, params[j]) <= end - start) {
+            return false;
+        }
+        D = heston_riccati_moment_solution(omega, D, end - start, params[j]);
+        end = start;
+    }
+    return true;
+}
+
+std::pair<double, double> piecewise_heston_critical_moments(
+    double T,
+    std::vector<double> &times,
+    std::vector<HestonParams> &params
+) {
+    return critical_moments([&](double omega) {
+        return piecewise_heston_moment_finite(omega, T, times, params);
+    });
+}
+
+void heston_cf_coefficients(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    HestonParams &params,
+    Eigen::RowVectorXcd &C,
+    Eigen::RowVectorXcd &D
+) {
+    typedef Eigen::Array<std::complex<double>, 1, Eigen::Dynamic> RowArrayXcd;
+    std::complex<double> i(0.0, 1.0);
+    double sigma_2 = params.sigma * params.sigma;
+
+    // Terms shared by C and D, b = kappa - rho*sigma*iu
+    RowArrayXcd b = params.kappa - (params.rho * params.sigma * i) * u.array();
+    RowArrayXcd d = (b.square() + sigma_2 * (i * u.array() + u.array().square())).sqrt();
+    RowArrayXcd b_minus_d = b - d;
+    RowArrayXcd g = b_minus_d / (b + d);
+    RowArrayXcd exp_d = (-tau * d).exp();
+    RowArrayXcd one_minus_g_exp = 1.0 - g * exp_d;
+
+    D = (b_minus_d / sigma_2 * (1.0 - exp_d) / one_minus_g_exp).matrix();
+    C = (((params.kappa * params.theta) / sigma_2) * (
+        b_minus_d * tau - 2.0 * (one_minus_g_exp / (1.0 - g)).log()
+    )).matrix();
+}
+
+void heston_cf_gradient(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    double v,
+    HestonParams &params,
+    Eigen::RowVectorXcd &C,
+    Eigen::RowVectorXcd &D,
+    Eigen::MatrixXcd &gradient
+) {
+    typedef Eigen::Array<std::complex<double>, 1, Eigen::Dynamic> RowArrayXcd;
+    std::complex<double> i(0.0, 1.0);
+    double sigma_2 = params.sigma * params.sigma;
+    double kappa_theta = params.kappa * params.theta;
+
+    // Intermediates of heston_cf_coefficients
+    RowArrayXcd i_u = i * u.array();
+    RowArrayXcd b = params.kappa - params.rho * params.sigma * i_u;
+    RowArrayXcd d = (b.square() + sigma_2 * (i_u + u.array().square())).sqrt();
+    RowArrayXcd b_minus_d = b - d;
+    RowArrayXcd b_plus_d = b + d;
+    RowArrayXcd g = b_minus_d / b_plus_d;
+    RowArrayXcd exp_d = (-tau * d).exp();
+    RowArrayXcd one_minus_g_exp = 1.0 - g * exp_d;
+    RowArrayXcd ratio = (1.0 - exp_d) / one_minus_g_exp;
+    RowArrayXcd bracket = b_minus_d * tau - 2.0 * (one_minus_g_exp / (1.0 - g)).log();
+
+    D = (b_minus_d / sigma_2 * ratio).matrix();
+    C = ((kappa_theta / sigma_2) * bracket).matrix();
+
+    // Derivatives w.r.t. v and theta are explicit
+    gradient.resize(5, u.cols());
+    gradient.row(0) = D;
+    gradient.row(3) = C / params.theta;
+
+    // Derivatives w.r.t. rho, kappa and sigma through b (and explicit sigma)
+    int rows[3] = {1, 2, 4};
+    for (int p=0; p<3; p++) {
+        RowArrayXcd b_p;
+        double sigma_p = 0;
+        if (p == 0) {
+            b_p = -params.sigma * i_u;
+        } else if (p == 1) {
+            b_p = RowArrayXcd::Ones(u.cols());
+        } else {
+            b_p = -params.rho * i_u;
+            sigma_p = 1;
+        }
+        RowArrayXcd d_p = (b * b_p + (params.sigma * sigma_p) * (i_u + u.array().square())) / d;
+        RowArrayXcd g_p = 2.0 * (b_p * d - b * d_p) / b_plus_d.square();
+        RowArrayXcd exp_d_p = -tau * d_p * exp_d;
+        RowArrayXcd g_exp_p = g_p * exp_d + g * exp_d_p;
+
+        RowArrayXcd ratio_p = (-exp_d_p + ratio * g_exp_p) / one_minus_g_exp;
+        RowArrayXcd D_p = ((b_p - d_p) * ratio + b_minus_d * ratio_p) / sigma_2;
+        RowArrayXcd bracket_p = (b_p - d_p) * tau + 2.0 * (g_exp_p / one_minus_g_exp - g_p / (1.0 - g));
+        RowArrayXcd C_p = (kappa_theta / sigma_2) * bracket_p;
+
+        // Explicit dependence of C on kappa and of C, D on sigma
+        if (p == 1) {
+            C_p += C.array() / params.kappa;
+        } else if (p == 2) {
+            C_p -= 2.0 * C.array() / params.sigma;
+            D_p -= 2.0 * D.array() / params.sigma;
+        }
+        gradient.row(rows[p]) = (C_p + v * D_p).matrix();
+    }
+}
+
+Eigen::RowVectorXcd
+heston_log_price_cf(const Eigen::RowVectorXcd &u, double x, double v, double t, double T, HestonParams &params)
+{
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd C, D;
+    heston_cf_coefficients(u, T - t, params, C, D);
+    return (C.array() + D.array() * v + (i * x) * u.array()).exp().matrix();
+}
+
+Eigen::RowVectorXcd
+heston_exp_option_cf(const Eigen::RowVectorXcd &u, double x, double v, double alpha, double T, HestonParams &params)
+{
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd shifted = u.array() - (alpha + 1) * i;
+    return (
+        heston_log_price_cf(shifted, x, v, 0, T, params).array() /
+        (alpha * alpha + alpha - u.array().square() + i * (2 * alpha + 1) * u.array())
+    ).matrix();
+}
+
+/**
+ * @brief           Calculate affine coefficients of char. function for a batch of parameter sets on a block of u
+ *
+ * @details         Kernel of batch heston_cf_coefficients working on real and imaginary parts separately.
+ *
+ * @param   u_re    Real parts of block of char. function arguments
+ * @param   u_im    Imaginary parts of block of char. function arguments
+ * @param   tau     Time to expiration
+ * @param   params  Batch of Heston model parameters
+ * @param   C_re    Output real parts of \f$ C \f$
+ * @param   C_im    Output imaginary parts of \f$ C \f$
+ * @param   D_re    Output real parts of \f$ D \f$
+ * @param   D_im    Output imaginary parts of \f$ D \f$
+ */
+static void cf_coefficients_block(
+    const Eigen::RowVectorXd &u_re,
+    const Eigen::RowVectorXd &u_im,
+    double tau,
+    const HestonParamsBatch &params,
+    Eigen::ArrayXXd &C_re,
+    Eigen::ArrayXXd &C_im,
+    Eigen::ArrayXXd &D_re,
+    Eigen::ArrayXXd &D_im
+) {
+    // Real arrays of parameter sets (rows) and arguments (columns), parameter sets are SIMD lanes
+    typedef Eigen::ArrayXXd Array;
+    Eigen::ArrayXd sigma_2 = params.sigma.square();
+    Eigen::ArrayXd rho_sigma = params.rho * params.sigma;
+
+    // b = kappa - rho*sigma*iu, iu = -Im(u) + iRe(u)
+    Array b_re = (rho_sigma.matrix() * u_im).array().colwise() + params.kappa;
+    Array b_im = -(rho_sigma.matrix() * u_re).array();
+
+    // d^2 = b^2 + sigma^2(iu + u^2)
+    Eigen::RowVectorXd w_re = (u_re.array().square() - u_im.array().square() - u_im.array()).matrix();
+    Eigen::RowVectorXd w_im = (u_re.array() * (2 * u_im.array() + 1)).matrix();
+    Array d_re = b_re.square() - b_im.square() + (sigma_2.matrix() * w_re).array();
+    Array d_im = 2 * b_re * b_im + (sigma_2.matrix() * w_im).array();
+
+    // Principal square root sqrt(z) = sqrt((|z|+Re z)/2) + i sign(Im z) sqrt((|z|-Re z)/2)
+    Array modulus = (d_re.square() + d_im.square()).sqrt();
+    Array root_im = ((modulus - d_re).max(0.0) / 2).sqrt();
+    d_re = ((modulus + d_re).max(0.0) / 2).sqrt();
+    d_im = root_im * unit_sign(d_im);
+
+    // g = (b - d) / (b + d)
+    Array b_minus_d_re = b_re - d_re;
+    Array b_minus_d_im = b_im - d_im;
+    Array b_plus_d_re = b_re + d_re;
+    Array b_plus_d_im = b_im + d_im;
+    Array norm = b_plus_d_re.square() + b_plus_d_im.square();
+    Array g_re = (b_minus_d_re * b_plus_d_re + b_minus_d_im * b_plus_d_im) / norm;
+    Array g_im = (b_minus_d_im * b_plus_d_re - b_minus_d_re * b_plus_d_im) / norm;
+
+    // exp(-d*tau)
+    Array exp_d_re, exp_d_im;
+    sin_cos(-tau * d_im, exp_d_im, exp_d_re);
+    Array exp_d_abs = (-tau * d_re).exp();
+    exp_d_re *= exp_d_abs;
+    exp_d_im *= exp_d_abs;
+
+    // 1 - g*exp(-d*tau)
+    Array one_minus_g_exp_re = 1 - (g_re * exp_d_re - g_im * exp_d_im);
+    Array one_minus_g_exp_im = -(g_re * exp_d_im + g_im * exp_d_re);
+
+    // D = (b - d) / sigma^2 * (1 - exp(-d*tau)) / (1 - g*exp(-d*tau))
+    norm = one_minus_g_exp_re.square() + one_minus_g_exp_im.square();
+    Array ratio_re = ((1 - exp_d_re) * one_minus_g_exp_re - exp_d_im * one_minus_g_exp_im) / norm;
+    Array ratio_im = (-exp_d_im * one_minus_g_exp_re - (1 - exp_d_re) * one_minus_g_exp_im) / norm;
+    D_re = (b_minus_d_re * ratio_re - b_minus_d_im * ratio_im).colwise() / sigma_2;
+    D_im = (b_minus_d_re * ratio_im + b_minus_d_im * ratio_re).colwise() / sigma_2;
+
+    // Principal logarithm of (1 - g*exp(-d*tau)) / (1 - g)
+    norm = (1 - g_re).square() + g_im.square();
+    Array quotient_re = (one_minus_g_exp_re * (1 - g_re) - one_minus_g_exp_im * g_im) / norm;
+    Array quotient_im = (one_minus_g_exp_im * (1 - g_re) + one_minus_g_exp_re * g_im) / norm;
+    Array log_re = 0.5 * (quotient_re.square() + quotient_im.square()).log();
+    Array log_im = argument(quotient_im, quotient_re);
+
+    // C = kappa*theta / sigma^2 * ((b - d)tau - 2log(...))
+    Eigen::ArrayXd factor = params.kappa * params.theta / sigma_2;
+    C_re = (tau * b_minus_d_re - 2 * log_re).colwise() * factor;
+    C_im = (tau * b_minus_d_im - 2 * log_im).colwise() * factor;
+
+}
+
+void heston_cf_coefficients(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    const HestonParamsBatch &params,
+    Eigen::MatrixXcd &C,
+    Eigen::MatrixXcd &D
+) {
+    int rows = params.size();
+    C.resize(rows, u.cols());
+    D.resize(rows, u.cols());
+
+    // Blocks of columns keep temporary arrays in cache
+    int width = std::max(1, CF_BATCH_BLOCK_SIZE / std::max(1, rows));
+    Eigen::ArrayXXd C_re, C_im, D_re, D_im;
+    for (int start=0; start<u.cols(); start+=width) {
+        int size = std::min(width, (int)u.cols() - start);
+        Eigen::RowVectorXcd block = u.segment(start, size);
+        cf_coefficients_block(block.real(), block.imag(), tau, params, C_re, C_im, D_re, D_im);
+        C.middleCols(start, size).real() = C_re.matrix();
+        C.middleCols(start, size).imag() = C_im.matrix();
+        D.middleCols(start, size).real() = D_re.matrix();
+        D.middleCols(start, size).imag() = D_im.matrix();
+    }
+}
+
+Eigen::MatrixXcd heston_log_price_cf(
+    const Eigen::RowVectorXcd &u,
+    double x,
+    const Eigen::ArrayXd &v,
+    double t,
+    double T,
+    const HestonParamsBatch &params
+) {
+    int rows = params.size();
+    Eigen::MatrixXcd result(rows, u.cols());
+
+    int width = std::max(1, CF_BATCH_BLOCK_SIZE / std::max(1, rows));
+    Eigen::ArrayXXd C_re, C_im, D_re, D_im, sine, cosine;
+    for (int start=0; start<u.cols(); start+=width) {
+        int size = std::min(width, (int)u.cols() - start);
+        Eigen::RowVectorXd u_re = u.segment(start, size).real();
+        Eigen::RowVectorXd u_im = u.segment(start, size).imag();
+        cf_coefficients_block(u_re, u_im, T - t, params, C_re, C_im, D_re, D_im);
+
+        // Exponent C + Dv + iux by real and imaginary parts
+        Eigen::ArrayXXd exponent_re = (C_re + D_re.colwise() * v).rowwise() - x * u_im.array();
+        Eigen::ArrayXXd exponent_im = (C_im + D_im.colwise() * v).rowwise() + x * u_re.array();
+        sin_cos(exponent_im, sine, cosine);
+        Eigen::ArrayXXd modulus = exponent_re.exp();
+        result.middleCols(start, size).real() = (modulus * cosine).matrix();
+        result.middleCols(start, size).imag() = (modulus * sine).matrix();
+    }
+    return result;
+}
+
+void check_jump_params(const JumpParams &jumps)
+{
+    if (jumps.lambda < 0) {
+        throw std::invalid_argument("Jumps intensity must be non-negative.");
+    }
+    if (jumps.sigma_s < 0) {
+        throw std::invalid_argument("Log price jump deviation must be non-negative.");
+    }
+    if (jumps.mu_v < 0) {
+        throw std::invalid_argument("Variance jump mean must be non-negative.");
+    }
+    if (jumps.rho_j * jumps.mu_v >= 1) {
+        throw std::invalid_argument("Product of jumps correlation and variance jump mean must be less than 1.");
+    }
+}
+
+Eigen::RowVectorXcd jump_price_transform(const Eigen::RowVectorXcd &u, JumpParams &jumps)
+{
+    std::complex<double> i(0.0, 1.0);
+    return ((i * jumps.mu_s) * u.array() - (0.5 * jumps.sigma_s * jumps.sigma_s) * u.array().square()).exp().matrix();
+}
+
+void svjj_jump_coefficient(
+    const Eigen::RowVectorXcd &u,
+    double tau,
+    HestonParams &params,
+    JumpParams &jumps,
+    const Eigen::RowVectorXcd &transform,
+    Eigen::RowVectorXcd &J
+) {
+    typedef Eigen::Array<std::complex<double>, 1, Eigen::Dynamic> RowArrayXcd;
+    std::complex<double> i(0.0, 1.0);
+    double mean_jump = std::exp(jumps.mu_s + 0.5 * jumps.sigma_s * jumps.sigma_s) / (1 - jumps.rho_j * jumps.mu_v) - 1;
+    RowArrayXcd i_u = i * u.array();
+    if ((jumps.lambda == 0) || (jumps.mu_v == 0)) {
+        J = (jumps.lambda * tau * (transform.array() - 1.0 - mean_jump * i_u)).matrix();
+        return;
+    }
+
+    // Heston intermediates as of heston_cf_coefficients, beta = (b - d) / sigma^2
+    double sigma_2 = params.sigma * params.sigma;
+    RowArrayXcd b = params.kappa - (params.rho * params.sigma) * i_u;
+    RowArrayXcd d = (b.square() + sigma_2 * (i_u + u.array().square())).sqrt();
+    RowArrayXcd beta = (b - d) / sigma_2;
+    RowArrayXcd g = (b - d) / (b + d);
+    RowArrayXcd exp_d = (-tau * d).exp();
+    RowArrayXcd one_minus_g_exp = 1.0 - g * exp_d;
+    RowArrayXcd D = beta * (1.0 - exp_d) / one_minus_g_exp;
+
+    // 1/(1 - mu_v(c + D)) = (1 - g e)/(A - B e), c = iu*rho_J, e = exp(-d*s), integrated over s in [0, tau]:
+    // tau/A - mu_v*beta*(1 - g)/(ABd) * ln((A - B e)/(A - B)), A - B e = (1 - g e)(1 - mu_v(c + D))
+    RowArrayXcd jump_free = 1.0 - (jumps.mu_v * jumps.rho_j) * i_u;
+    RowArrayXcd A = jump_free - jumps.mu_v * beta;
+    RowArrayXcd B = jump_free * g - jumps.mu_v * beta;
+    RowArrayXcd log_ratio = (one_minus_g_exp / (1.0 - g)).log() + ((jump_free - jumps.mu_v * D) / jump_free).log();
+
+    // Removable singularity at B = 0 (e.g. u = 0 and u = -i, where beta = g = 0): ln(...)/B -> (1 - e)/(A - B)
+    RowArrayXcd log_ratio_per_B = (B.abs() > JUMP_SINGULARITY_TOLERANCE).select(
+        log_ratio / B, (1.0 - exp_d) / (A - B)
+    );
+    RowArrayXcd integral = tau / A - jumps.mu_v * beta * (1.0 - g) / (A * d) * log_ratio_per_B;
+    J = (jumps.lambda * (transform.array() * integral - tau * (1.0 + mean_jump * i_u))).matrix();
+}
+
+Eigen::RowVectorXcd svjj_jump_rate(
+    const Eigen::RowVectorXcd &u,
+    const Eigen::RowVectorXcd &D,
+    JumpParams &jumps,
+    const Eigen::RowVectorXcd &transform
+) {
+    std::complex<double> i(0.0, 1.0);
+    double mean_jump = std::exp(jumps.mu_s + 0.5 * jumps.sigma_s * jumps.sigma_s) / (1 - jumps.rho_j * jumps.mu_v) - 1;
+    return (jumps.lambda * (
+        transform.array() / (1.0 - jumps.mu_v * ((jumps.rho_j * i) * u.array() + D.array())) - 1.0
+        - (mean_jump * i) * u.array()
+    )).matrix();
+}
+
+bool svjj_moment_finite(double omega, double T, HestonParams &params, JumpParams &jumps)
+{
+    if (!(heston_moment_explosion_time(omega, params) > T)) {
+        return false;
+    }
+    if ((jumps.lambda == 0) || (jumps.mu_v == 0)) {
+        return true;
+    }
+
+    // D(-i*omega, tau) is real
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd u(1), C, D;
+    u << -i * omega;
+    heston_cf_coefficients(u, T, params, C, D);
+    return (1 - jumps.mu_v * omega * jumps.rho_j > 0) && (1 - jumps.mu_v * (omega * jumps.rho_j + D[0].real()) > 0);
+}
+
+std::pair<double, double> svjj_critical_moments(double T, HestonParams &params, JumpParams &jumps)
+{
+    return critical_moments([&](double omega) {
+        return svjj_moment_finite(omega, T, params, jumps);
+    });
+}
+
+Eigen::RowVectorXcd svjj_log_price_cf(
+    const Eigen::RowVectorXcd &u,
+    double x,
+    double v,
+    double t,
+    double T,
+    HestonParams &params,
+    JumpParams &jumps
+) {
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd C, D, J;
+    heston_cf_coefficients(u, T - t, params, C, D);
+    svjj_jump_coefficient(u, T - t, params, jumps, jump_price_transform(u, jumps), J);
+    return (C.array() + J.array() + v * D.array() + (i * x) * u.array()).exp().matrix();
+}
+
+HestonModel::HestonModel(const HestonParams &_params, double _v_0)
+{
+    set_params(_params);
+    set_v0(_v_0);
+}
+
+void HestonModel::log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result)
+{
+    heston_cf_coefficients(u, T, params, C, D);
+    result = C + v_0 * D;
+}
+
+std::pair<double, double> HestonModel::moment_strip(double T)
+{
+    return heston_critical_moments(T, params);
+}
+
+void HestonModel::set_params(const HestonParams &_params)
+{
+    params = _params;
+}
+
+HestonParams HestonModel::get_params()
+{
+    return params;
+}
+
+void HestonModel::set_v0(double _v_0)
+{
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0 = _v_0;
+}
+
+double HestonModel::get_v0()
+{
+    return v_0;
+}
+
+SvjjModel::SvjjModel(const HestonParams &_params, const JumpParams &_jumps, double _v_0)
+{
+    set_params(_params);
+    set_jumps(_jumps);
+    set_v0(_v_0);
+}
+
+void SvjjModel::log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result)
+{
+    // Jump price transform does not depend on maturity, recalculate it for a new grid only
+    if ((transform_grid.cols() != u.cols()) || (transform_grid != u)) {
+        transform_grid = u;
+        transform = jump_price_transform(u, jumps);
+    }
+    heston_cf_coefficients(u, T, params, C, D);
+    svjj_jump_coefficient(u, T, params, jumps, transform, J);
+    result = C + J + v_0 * D;
+}
+
+std::pair<double, double> SvjjModel::moment_strip(double T)
+{
+    return svjj_critical_moments(T, params, jumps);
+}
+
+void SvjjModel::set_params(const HestonParams &_params)
+{
+    params = _params;
+}
+
+HestonParams SvjjModel::get_params()
+{
+    return params;
+}
+
+void SvjjModel::set_jumps(const JumpParams &_jumps)
+{
+    check_jump_params(_jumps);
+    jumps = _jumps;
+    transform_grid.resize(0);
+}
+
+JumpParams SvjjModel::get_jumps()
+{
+    return jumps;
+}
+
+void SvjjModel::set_v0(double _v_0)
+{
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0 = _v_0;
+}
+
+double SvjjModel::get_v0()
+{
+    return v_0;
+}
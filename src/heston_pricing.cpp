@@ -4,6 +4,41 @@
  */
 #include "heston_pricing.h"
 
+//! Points count of circle of damped cumulant generating function derivatives.
+#define SADDLEPOINT_NODES 16
+
+//! Circle radius relative to distance to nearest singularity.
+#define SADDLEPOINT_RADIUS 0.25
+
+//! Largest circle radius.
+#define SADDLEPOINT_MAX_RADIUS 1.0
+
+//! Part of damping exponent interval next to critical moment, where saddlepoint search stops.
+#define SADDLEPOINT_EDGE 0.02
+
+//! Maximal iterations count and relative tolerance of saddlepoint search.
+#define SADDLEPOINT_MAX_ITERATIONS 100
+#define SADDLEPOINT_TOLERANCE 1e-10
+
+//! Step of damped price quadrature relative to saddlepoint width.
+#define WING_STEP 0.5
+
+//! Largest step of damped price quadrature relative to distance to the nearest singularity of damping strip.
+#define WING_STRIP_STEP 0.15
+
+//! Nodes count of one batch of damped price quadrature and maximal nodes count.
+#define WING_BLOCK 64
+#define WING_MAX_NODES 65536
+
+//! Relative size of integrand at which damped price quadrature is truncated.
+#define WING_TOLERANCE 1e-17
+
+//! Distance to the mean (in standard deviations), where Lugannani-Rice formula is replaced by its limit.
+#define LUGANNANI_RICE_CENTRE 1e-3
+
+//! Part of tail exponent interval next to critical moment, beyond which moment formula extrapolates.
+#define LUGANNANI_RICE_EDGE 1e-3
+
 HestonEuropeanOptionCalculator::HestonEuropeanOptionCalculator(
     double _r,
     double _s_0,
@@ -23,6 +58,11 @@ HestonEuropeanOptionCalculator::HestonEuropeanOptionCalculator(
         throw std::invalid_argument("Starting volatility must be non-negative.");
     }
     r = _r; s_0 = _s_0; v_0 = _v_0; params = _params;
+    strikes_evaluation = SPLINE_EVALUATION;
+    wing_moneyness = std::numeric_limits<double>::infinity();
+    wings_evaluation = SADDLEPOINT_WINGS;
+    JumpParams no_jumps = {0, 0, 0, 0, 0};
+    jumps = no_jumps;
     set_calculator_params(alpha, N, d_u);
 };
 
@@ -36,23 +76,90 @@ void HestonEuropeanOptionCalculator::set_calculator_params(
     int _N, 
     double _d_u
 ) {
-    if (_alpha <= 0) {
-        throw std::invalid_argument("Parameter alpha must be non-negative.");
-    }
-    if ((_N <= 0) || (_N % 2 == 1)) {
-        throw std::invalid_argument("Grid size must be non-negative and even.");
-    }
-    if (_d_u <= 0) {
-        throw std::invalid_argument("Grid step must be non-negative.");
-    }
+    check_carr_madan_params(_alpha, _N, _d_u);
     d_u = _d_u;
     N = _N;
     alpha = _alpha;
+    direct_threshold = 0;
 
     // Set strikes grid step for FFT usage
     d_k = 2 * M_PI / (d_u * N);
+
+    // Coefficients and surfaces of previous grid are invalid
+    clear_cache();
+    integrand_weights = carr_madan_weights(alpha, N, d_u);
+
+    // Jump price transform is the same for all maturities
+    if (jumps.lambda > 0) {
+        jump_transform = jump_price_transform(carr_madan_arguments(alpha, N, d_u), jumps);
+    }
 };
 
+void HestonEuropeanOptionCalculator::set_spot(double _s_0)
+{
+    if (_s_0 <= 0) {
+        throw std::invalid_argument("Starting spot price must be non-negative.");
+    }
+    s_0 = _s_0;
+}
+
+double HestonEuropeanOptionCalculator::get_spot()
+{
+    return s_0;
+}
+
+void HestonEuropeanOptionCalculator::set_v0(double _v_0)
+{
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0 = _v_0;
+}
+
+double HestonEuropeanOptionCalculator::get_v0()
+{
+    return v_0;
+}
+
+void HestonEuropeanOptionCalculator::set_params(HestonParams &_params)
+{
+    params = _params;
+    coefficients_cache.clear();
+}
+
+HestonParams HestonEuropeanOptionCalculator::get_params()
+{
+    return params;
+}
+
+void HestonEuropeanOptionCalculator::set_jumps(const JumpParams &_jumps)
+{
+    check_jump_params(_jumps);
+    jumps = _jumps;
+    clear_cache();
+    if (jumps.lambda > 0) {
+        jump_transform = jump_price_transform(carr_madan_arguments(alpha, N, d_u), jumps);
+    }
+}
+
+void HestonEuropeanOptionCalculator::set_jumps(const JumpParams &_jumps, const Eigen::RowVectorXcd &transform)
+{
+    check_jump_params(_jumps);
+    if ((_jumps.lambda > 0) && (transform.cols() != N)) {
+        throw std::invalid_argument("Jump price transform must be of grid size.");
+    }
+    jumps = _jumps;
+    clear_cache();
+    if (jumps.lambda > 0) {
+        jump_transform = transform;
+    }
+}
+
+JumpParams HestonEuropeanOptionCalculator::get_jumps()
+{
+    return jumps;
+}
+
 double HestonEuropeanOptionCalculator::get_alpha()
 {
     return alpha;
@@ -75,44 +182,22 @@ double HestonEuropeanOptionCalculator::get_d_k()
 
 Eigen::RowVectorXd HestonEuropeanOptionCalculator::get_log_strike_grid()
 {
-    return Eigen::RowVectorXd::LinSpaced(N, -N * d_k / 2, (N / 2 - 1) * d_k);
+    return carr_madan_log_strikes(N, d_u);
 }
 
 
 std::pair<bool, double> HestonEuropeanOptionCalculator::integrate_condition(double T)
 {
-    // Calculate discriminant
-    double k = alpha * (alpha + 1) / 2;
-    double sigma_2 = params.sigma * params.sigma;
-    double b = 2 * k / sigma_2;
-    double a = (2 * params.rho * (alpha + 1) - params.kappa) / sigma_2;
-    double D = a * a - 4 * b;
-    double gamma = std::sqrt(std::abs(D)) / 2;
-
-    // Resulting pair
+    // Resulting pair, T* = 0 stands for T* = +infty
     std::pair<bool, double> result(true, 0);
-
-    // Calculate T*
-    if (D >= 0) {
-        if (a < 0) {
-            // T* = +infty
-            return result;
-        } else {
-            result.second = sigma_2 * std::log(
-                (a/2 + gamma) / (a/2 - gamma)
-            ) / gamma;
-        }
-    } else {
-        if (a < 0) {
-            result.second = 2 * sigma_2 * (
-                M_PI + std::atan(2 * gamma / a)
-            ) / gamma;
-        } else {
-            result.second = 2 * sigma_2 * (
-                std::atan(2 * gamma / a)
-            ) / gamma;
-        }
+    double explosion_time = heston_moment_explosion_time(alpha + 1, params);
+    if ((jumps.lambda > 0) && (jumps.mu_v > 0) && !svjj_moment_finite(alpha + 1, T, params, jumps)) {
+        result.first = false;
     }
+    if (std::isinf(explosion_time)) {
+        return result;
+    }
+    result.second = explosion_time;
 
     // Calculate the flag
     if (T >= result.second) {
@@ -122,44 +207,806 @@ std::pair<bool, double> HestonEuropeanOptionCalculator::integrate_condition(doub
     return result;
 }
 
-Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate(EuropeanOption &option)
+const std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd> &HestonEuropeanOptionCalculator::affine_coefficients(double T)
+{
+    std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd> *cached = coefficients_cache.find(T);
+    if (cached != NULL) {
+        return *cached;
+    }
+
+    // Char. function argument w = u - (alpha + 1)i
+    Eigen::RowVectorXcd w = carr_madan_arguments(alpha, N, d_u);
+    std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd> &coefficients = coefficients_cache.insert(
+        T, std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd>()
+    );
+    heston_cf_coefficients(w, T, params, coefficients.first, coefficients.second);
+    if (jumps.lambda > 0) {
+        Eigen::RowVectorXcd J;
+        svjj_jump_coefficient(w, T, params, jumps, jump_transform, J);
+        coefficients.first += J;
+    }
+    return coefficients;
+}
+
+Eigen::RowVectorXcd HestonEuropeanOptionCalculator::integrand(double T)
+{
+    return integrand(T, s_0);
+}
+
+Eigen::RowVectorXcd HestonEuropeanOptionCalculator::integrand(double T, double spot)
 {
     // Check Andersen-Piterbarg condition
-    std::pair<bool, double> flag = integrate_condition(option.get_maturity());
+    std::pair<bool, double> flag = integrate_condition(T);
     if (!flag.first) {
         throw std::invalid_argument("Andersen-Piterbarg condition is false.");
     }
+    const std::pair<Eigen::RowVectorXcd, Eigen::RowVectorXcd> &coefficients = affine_coefficients(T);
 
-    // Get u, log strikes grids
-    Eigen::RowVectorXd log_strikes = get_log_strike_grid();
-    Eigen::RowVectorXcd u_grid = Eigen::RowVectorXd::LinSpaced(N, 0, (N-1) * d_u);
+    // Calculate characteristic function of undistounted call option price, multiplied by exp(-alpha*lnK),
+    // iwx = (alpha + 1)x + iux
+    std::complex<double> i(0.0, 1.0);
+    double x = std::log(spot * df(T, 0));
+    Eigen::RowVectorXd u_grid = Eigen::RowVectorXd::LinSpaced(N, 0, (N-1) * d_u);
+    return (
+        (coefficients.first.array() + v_0 * coefficients.second.array() + (alpha + 1) * x + (i * x) * u_grid.array()).exp()
+        * integrand_weights.array()
+    ).matrix();
+}
 
-    // Calculate characteristic function of undistounted call option price, multiplied by exp(-alpha*lnK)
-    Eigen::RowVectorXcd exp_option_cf(N);
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::prices_from_transform(
+    EuropeanOption &option,
+    const Eigen::RowVectorXd &log_strikes,
+    const Eigen::RowVectorXcd &transform
+) {
     double T = option.get_maturity();
-    double x = std::log(s_0 * df(T, 0));
-    for (int i=0; i<N; i++) {
-        std::complex<double> mult((-1 + 2*((i+1)%2)), 0);
-        exp_option_cf[i] = mult * heston_exp_option_cf(u_grid[i], x, v_0, alpha, T, params);
-    }
+    Eigen::RowVectorXd result;
+    carr_madan_prices(
+        transform, carr_madan_damping(alpha, d_u, log_strikes), log_strikes.array().exp(),
+        df(0, T), s_0, option.is_call(), result
+    );
+    return result;
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate(EuropeanOption &option)
+{
+    Eigen::RowVectorXcd exp_option_cf = integrand(option.get_maturity());
+
+    // Alternate signs to shift log strikes grid to [-N*d_k/2, N*d_k/2)
+    exp_option_cf(Eigen::seq(1, N - 1, 2)) *= -1.0;
 
     // Approximate continous Fourier transform by discrete using FFT algorithm
     Eigen::RowVectorXcd integr_appr = fft(exp_option_cf);
 
-    // Result call option prices
-    Eigen::RowVectorXd result(N);
+    return prices_from_transform(option, get_log_strike_grid(), integr_appr);
+}
+
+Eigen::RowVectorXcd HestonEuropeanOptionCalculator::maturity_log_cf_derivative(double T)
+{
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd w = carr_madan_arguments(alpha, N, d_u);
+    Eigen::ArrayXXcd i_w = i * w.array();
+    const Eigen::RowVectorXcd &D = affine_coefficients(T).second;
+    Eigen::ArrayXXcd b = params.kappa - params.rho * params.sigma * i_w;
+    Eigen::RowVectorXcd result = (
+        params.kappa * params.theta * D.array() + v_0 * (
+            0.5 * (i_w * i_w - i_w) - b * D.array() + 0.5 * params.sigma * params.sigma * D.array().square()
+        )
+    ).matrix();
+    if (jumps.lambda > 0) {
+        result += svjj_jump_rate(w, D, jumps, jump_transform);
+    }
+    return result;
+}
+
+Eigen::ArrayXXd HestonEuropeanOptionCalculator::log_strike_derivatives(double T, bool maturity_derivative)
+{
+    Eigen::RowVectorXcd psi = integrand(T);
+
+    // Multiplier of d/dk is -alpha - iu
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd u_grid = Eigen::RowVectorXd::LinSpaced(N, 0, (N-1) * d_u);
+    Eigen::ArrayXXcd d_k_multiplier = -alpha - i * u_grid.array();
+
+    Eigen::MatrixXcd stacked(maturity_derivative ? 4 : 3, N);
+    stacked.row(0) = psi;
+    stacked.row(1) = (d_k_multiplier * psi.array()).matrix();
+    stacked.row(2) = (d_k_multiplier.square() * psi.array()).matrix();
+    if (maturity_derivative) {
+        stacked.row(3) = (maturity_log_cf_derivative(T).array() * psi.array()).matrix();
+    }
+
+    // Alternate signs to shift log strikes grid to [-N*d_k/2, N*d_k/2)
+    stacked(Eigen::all, Eigen::seq(1, N - 1, 2)) *= -1.0;
+    Eigen::MatrixXcd transform = fft(stacked);
+
+    Eigen::RowVectorXd factor = df(0, T) * carr_madan_damping(alpha, d_u, get_log_strike_grid());
+    Eigen::ArrayXXd result = transform.real().array().rowwise() * factor.array();
+
+    // d/dT at fixed K: discounting gives -rC, x = ln(s_0) + rT gives r(C - dC/dk)
+    if (maturity_derivative) {
+        result.row(3) -= r * result.row(1);
+    }
+    return result;
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate(
+    EuropeanOption &option,
+    Eigen::RowVectorXd &d_strike,
+    Eigen::RowVectorXd &d_strike2
+) {
+    double T = option.get_maturity();
+    Eigen::ArrayXXd derivatives = log_strike_derivatives(T, false);
+    Eigen::ArrayXXd strikes = get_log_strike_grid().array().exp();
+    d_strike = (derivatives.row(1) / strikes).matrix();
+    d_strike2 = ((derivatives.row(2) - derivatives.row(1)) / strikes.square()).matrix();
+
+    if (option.is_call()) {
+        return derivatives.row(0).matrix();
+    }
+
+    // If option is of put type, use the Put-Call parity
+    d_strike = d_strike.array() + df(0, T);
+    return (derivatives.row(0) + df(0, T) * strikes - s_0).matrix();
+}
+
+Eigen::MatrixXd HestonEuropeanOptionCalculator::calculate_local_volatility(const Eigen::RowVectorXd &maturities)
+{
+    if ((maturities.cols() > 0) && (maturities.minCoeff() <= 0)) {
+        throw std::invalid_argument("Maturities must be positive.");
+    }
+
+    Eigen::MatrixXd result(maturities.cols(), N);
+    for (int j=0; j<maturities.cols(); j++) {
+        Eigen::ArrayXXd derivatives = log_strike_derivatives(maturities[j], true);
+
+        // In log strike rK dC/dK cancels with dC/dT term of x = ln(s_0) + rT
+        Eigen::ArrayXXd numerator = derivatives.row(3) + r * derivatives.row(1);
+        Eigen::ArrayXXd denominator = 0.5 * (derivatives.row(2) - derivatives.row(1));
+        result.row(j) = ((numerator > 0) && (denominator > 0)).select(
+            (numerator / denominator).sqrt(), std::numeric_limits<double>::quiet_NaN()
+        ).matrix();
+    }
+    return result;
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate(EuropeanOption &option, const Eigen::RowVectorXi &bins)
+{
+    if ((bins.cols() > 0) && ((bins.minCoeff() < 0) || (bins.maxCoeff() >= N))) {
+        throw std::invalid_argument("Bins must be indices of log strike grid.");
+    }
+
+    // Full transform is cheaper for many bins
+    if (bins.cols() >= get_direct_threshold()) {
+        return calculate(option)(bins);
+    }
+
+    Eigen::RowVectorXcd exp_option_cf = integrand(option.get_maturity());
+
+    // Alternate signs to shift log strikes grid to [-N*d_k/2, N*d_k/2)
+    exp_option_cf(Eigen::seq(1, N - 1, 2)) *= -1.0;
+
+    // Sum DFT bins 2*pi*n/N directly
+    Eigen::RowVectorXd phases = (2 * M_PI / N) * bins.cast<double>();
+    Eigen::RowVectorXcd integr_appr = goertzel(exp_option_cf, phases);
+
+    return prices_from_transform(option, get_log_strike_grid()(bins), integr_appr);
+}
+
+int HestonEuropeanOptionCalculator::benchmark_direct_threshold()
+{
+    Eigen::RowVectorXcd vector = Eigen::RowVectorXcd::Random(N);
+    Eigen::RowVectorXd phase = Eigen::RowVectorXd::Constant(1, 1.0);
+
+    // Repeat every method until at least a millisecond is elapsed
+    double seconds[2];
+    for (int method=0; method<2; method++) {
+        int repeats = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed(0);
+        while ((repeats < 3) || (elapsed.count() < 1e-3)) {
+            if (method == 0) {
+                fft(vector);
+            } else {
+                goertzel(vector, phase);
+            }
+            repeats++;
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        seconds[method] = elapsed.count() / repeats;
+    }
+    direct_threshold = std::max(1, (int)std::ceil(seconds[0] / seconds[1]));
+    return direct_threshold;
+}
+
+int HestonEuropeanOptionCalculator::get_direct_threshold()
+{
+    if (direct_threshold <= 0) {
+        benchmark_direct_threshold();
+    }
+    return direct_threshold;
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate_at(EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    if (std::isinf(wing_moneyness)) {
+        return evaluate_at(option, strikes);
+    }
+
+    // Indices of inner and wing strikes
+    double forward = s_0 * df(option.get_maturity(), 0);
+    std::vector<int> inner, wings;
+    for (int j=0; j<strikes.cols(); j++) {
+        if (std::abs(std::log(strikes[j] / forward)) > std::log(wing_moneyness)) {
+            wings.push_back(j);
+        } else {
+            inner.push_back(j);
+        }
+    }
+
+    Eigen::RowVectorXd result(strikes.cols());
+    if (!inner.empty()) {
+        result(inner) = evaluate_at(option, strikes(inner));
+    }
+    if (!wings.empty()) {
+        result(wings) = calculate_wings(option, strikes(wings));
+    }
+    return result;
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::evaluate_at(EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    Eigen::RowVectorXd log_strikes = strikes.array().log();
+
+    if (strikes_evaluation == SPLINE_EVALUATION) {
+        // Interpolate grid prices in log strike
+        UniformCubicSpline spline(-N * d_k / 2, d_k, calculate(option));
+        return spline.evaluate(log_strikes);
+    }
+
+    if (strikes_evaluation == DIRECT_EVALUATION) {
+        // Sum integrand at phases u_n*k_j = n*(d_u*k_j) directly, no grid restrictions
+        Eigen::RowVectorXcd integr_appr = goertzel(integrand(option.get_maturity()), d_u * log_strikes);
+        return prices_from_transform(option, log_strikes, integr_appr);
+    }
+
+    // Sum integrand directly at phases u_n*k_j = n*(d_u*k_j) by NUFFT
+    if (!inside_grid(log_strikes)) {
+        throw std::invalid_argument("Strikes must lie inside the log strike grid.");
+    }
+    Eigen::RowVectorXcd integr_appr = nufft(integrand(option.get_maturity()), d_u * log_strikes);
+    return prices_from_transform(option, log_strikes, integr_appr);
+}
+
+Eigen::RowVectorXcd HestonEuropeanOptionCalculator::log_moment(double T, const Eigen::RowVectorXcd &z)
+{
+    // Moment E[(F_T/F)^(z+1)] is char. function at u = -i(z+1)
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd C, D;
+    Eigen::RowVectorXcd moment_u = (-i * (z.array() + 1.0)).matrix();
+    heston_cf_coefficients(moment_u, T, params, C, D);
+    if (jumps.lambda > 0) {
+        Eigen::RowVectorXcd J;
+        svjj_jump_coefficient(moment_u, T, params, jumps, jump_price_transform(moment_u, jumps), J);
+        C += J;
+    }
+    return C + v_0 * D;
+}
+
+Eigen::VectorXd HestonEuropeanOptionCalculator::damped_cgf(
+    double T,
+    double a,
+    double radius,
+    bool zero_pole,
+    bool unit_pole
+) {
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXd angles = Eigen::RowVectorXd::LinSpaced(
+        SADDLEPOINT_NODES, 0, 2 * M_PI * (SADDLEPOINT_NODES - 1) / SADDLEPOINT_NODES
+    );
+    Eigen::ArrayXXcd unit = (i * angles.array()).exp();
+    Eigen::RowVectorXcd z = (a + radius * unit).matrix();
+
+    // Circle does not enclose poles, so signs of a and a+1 keep logarithms on principal branch
+    Eigen::ArrayXXcd values = log_moment(T, z).array();
+    if (zero_pole) {
+        values -= ((a > 0 ? 1.0 : -1.0) * z.array()).log();
+    }
+    if (unit_pole) {
+        values -= ((a > -1 ? 1.0 : -1.0) * (z.array() + 1.0)).log();
+    }
+
+    // Taylor coefficients by trapezoid rule of Cauchy integral, e^{-in theta} are powers of conjugate nodes
+    Eigen::VectorXd result(5);
+    double factorial = 1;
+    for (int n=0; n<5; n++) {
+        result[n] = factorial * values.sum().real() / (SADDLEPOINT_NODES * std::pow(radius, n));
+        values *= unit.conjugate();
+        factorial *= n + 1;
+    }
+    return result;
+}
+
+double HestonEuropeanOptionCalculator::saddlepoint_exponent(
+    double T,
+    double y,
+    double lower,
+    double upper,
+    Eigen::VectorXd &cgf,
+    bool zero_pole,
+    bool unit_pole,
+    double guess
+) {
+    // Safeguarded Newton iterations on convex Lambda, Lambda'(a) = y is bracketed by [low, high]
+    double low = lower, high = upper;
+    double a = std::isinf(upper) ? lower + 1 : (std::isinf(lower) ? upper - 1 : 0.5 * (lower + upper));
+    if ((guess > lower) && (guess < upper)) {
+        a = guess;
+    }
+    for (int iteration=0; iteration<SADDLEPOINT_MAX_ITERATIONS; iteration++) {
+        double radius = std::min(SADDLEPOINT_RADIUS * std::min(a - lower, upper - a), SADDLEPOINT_MAX_RADIUS);
+        cgf = damped_cgf(T, a, radius, zero_pole, unit_pole);
+        if (cgf[1] > y) {
+            high = a;
+        } else {
+            low = a;
+        }
+
+        // Newton step, bisection (or doubling distance to the finite bound) outside of bracket
+        double next = a - (cgf[1] - y) / cgf[2];
+        if (!((next > low) && (next < high))) {
+            if (std::isinf(high)) {
+                next = lower + 2 * (a - lower);
+            } else if (std::isinf(low)) {
+                next = upper - 2 * (upper - a);
+            } else {
+                next = 0.5 * (low + high);
+            }
+        }
+        if (std::abs(next - a) <= SADDLEPOINT_TOLERANCE * std::max(1.0, std::abs(a))) {
+            break;
+        }
+        a = next;
+    }
+    return a;
+}
+
+double HestonEuropeanOptionCalculator::damped_price(
+    double T,
+    double y,
+    double a,
+    double lower,
+    double upper,
+    const Eigen::VectorXd &cgf
+) {
+    // Step resolves the Gaussian width at saddlepoint and, off saddlepoint, the phase e^{-iu(y - Lambda')};
+    // trapezoid rule error decays as e^{-2pi d/h} with distance d to the strip bounds
+    double h = std::min(
+        WING_STEP / std::max(std::sqrt(cgf[2]), std::abs(y - cgf[1])),
+        WING_STRIP_STEP * std::min(a - lower, upper - a)
+    );
+    std::complex<double> i(0.0, 1.0);
+
+    // Real part of integrand is even in u, so trapezoid rule on the half line with halved u = 0 term is
+    // spectrally accurate; char. function decays exponentially, batches are added until it is negligible
+    double sum = 0, peak = 0;
+    for (int start=0; start<WING_MAX_NODES; start+=WING_BLOCK) {
+        Eigen::RowVectorXcd z = (a + i * h * Eigen::RowVectorXd::LinSpaced(
+            WING_BLOCK, start, start + WING_BLOCK - 1
+        ).array()).matrix();
+        Eigen::ArrayXXcd values = (log_moment(T, z).array() - z.array() * y).exp() / (z.array() * (z.array() + 1.0));
+        if (start == 0) {
+            values(0, 0) *= 0.5;
+            peak = std::abs(values(0, 0));
+        }
+        sum += values.real().sum();
+        if (values.abs().maxCoeff() <= WING_TOLERANCE * peak) {
+            break;
+        }
+    }
+    return h * sum / M_PI;
+}
+
+double HestonEuropeanOptionCalculator::lugannani_rice_price(
+    double y,
+    double a,
+    bool is_call,
+    const Eigen::VectorXd &cgf
+) {
+    // Tail variable is y for calls and -y for puts, exponent s = a for calls and -a-1 for puts
+    double s = is_call ? a : -a - 1;
+    double lambda_3 = (is_call ? 1 : -1) * cgf[3] / std::pow(cgf[2], 1.5);
+    double lambda_4 = cgf[4] / (cgf[2] * cgf[2]);
+    double scale = is_call ? 1 : std::exp(y);
+
+    // Convexity makes s*y' - K(s) = a*y - Lambda (+ y for puts) non-negative up to rounding
+    double w = std::sqrt(2 * std::max(a * y - cgf[0] + (is_call ? 0 : y), 0.0));
+    w = (s > 0) ? w : -w;
+    if (std::abs(w) < LUGANNANI_RICE_CENTRE) {
+        return scale * (0.5 - lambda_3 / (6 * std::sqrt(2 * M_PI)));
+    }
+    double u = s * std::sqrt(cgf[2]);
+    double density = std::exp(-0.5 * w * w) / std::sqrt(2 * M_PI);
+    double tail = 0.5 * std::erfc(w / std::sqrt(2)) + density * (1 / u - 1 / w);
+
+    // Second order term is kept only while it is small, as terms of asymptotic series
+    double correction = density * (
+        (lambda_4 / 8 - 5 * lambda_3 * lambda_3 / 24) / u - lambda_3 / (2 * u * u) - 1 / (u * u * u) + 1 / (w * w * w)
+    );
+    if (std::abs(correction) < 0.5 * tail) {
+        tail += correction;
+    }
+    return scale * tail;
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate_wings(
+    EuropeanOption &option,
+    const Eigen::RowVectorXd &strikes
+) {
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    double T = option.get_maturity();
+    double forward = s_0 * df(T, 0);
+
+    // Damping exponents of out-of-the-money puts and calls lie in (w_- - 1, -1) and (0, w_+ - 1),
+    // cumulants of Lugannani-Rice tails are analytic up to the dropped pole, in (w_- - 1, 0) and (-1, w_+ - 1)
+    std::pair<double, double> moments = svjj_critical_moments(T, params, jumps);
+    bool quadrature = (wings_evaluation == QUADRATURE_WINGS);
+    double lower[2] = {moments.first - 1, quadrature ? 0.0 : -1.0};
+    double upper[2] = {quadrature ? -1.0 : 0.0, moments.second - 1};
+
+    // Lee moment formula slopes of total implied variance
+    double slope[2];
+    for (int side=0; side<2; side++) {
+        double p = (side == 1) ? moments.second - 1 : -moments.first;
+        slope[side] = 2 - 4 * (std::sqrt(p * p + p) - p);
+    }
+
+    // Exponents next to finite critical moments, their cumulants and total implied variances,
+    // calculated at first use
+    double edge_a[2], edge_variance[2];
+    Eigen::VectorXd edge_cgf[2];
+    bool edge_ready[2] = {false, false};
+
+    // Saddlepoints of neighbouring strikes are close, the last one of each side gives Newton guess of the next
+    double previous_a[2];
+    Eigen::VectorXd previous_cgf[2];
+
+    Eigen::RowVectorXd result(strikes.cols());
+    for (int j=0; j<strikes.cols(); j++) {
+        double y = std::log(strikes[j] / forward);
+        int side = (y > 0) ? 1 : 0;
+        double critical = (side == 1) ? upper[side] : lower[side];
+
+        // Lugannani-Rice tail cumulants keep only the pole at -1 for calls and at 0 for puts
+        bool zero_pole = quadrature || (side == 0);
+        bool unit_pole = quadrature || (side == 1);
+
+        if (!std::isinf(critical) && !edge_ready[side]) {
+            double edge = quadrature ? SADDLEPOINT_EDGE : LUGANNANI_RICE_EDGE;
+            edge_a[side] = critical - (side == 1 ? 1 : -1) * edge * (upper[side] - lower[side]);
+            double radius = std::min(
+                SADDLEPOINT_RADIUS * std::min(edge_a[side] - lower[side], upper[side] - edge_a[side]),
+                SADDLEPOINT_MAX_RADIUS
+            );
+            edge_cgf[side] = damped_cgf(T, edge_a[side], radius, zero_pole, unit_pole);
+            if (!quadrature) {
+                // Total implied variance of the last saddlepoint strike is found by implied_vols()
+                Eigen::RowVectorXd edge_strike(1), edge_price(1);
+                double edge_y = edge_cgf[side][1];
+                edge_strike << forward * std::exp(edge_y);
+                edge_price << df(0, T) * forward * lugannani_rice_price(edge_y, edge_a[side], side == 1, edge_cgf[side]);
+                double volatility = implied_vols(edge_strike, edge_price, T, r, s_0, side == 1)[0];
+                edge_variance[side] = volatility * volatility * T;
+            }
+            edge_ready[side] = true;
+        }
+        bool beyond_edge = !std::isinf(critical) && (std::abs(y) >= std::abs(edge_cgf[side][1]));
+        double guess = std::numeric_limits<double>::quiet_NaN();
+        if (previous_cgf[side].size() > 0) {
+            // Second order inversion of Lambda' at the previous saddlepoint
+            double shift = y - previous_cgf[side][1];
+            double curvature = previous_cgf[side][2];
+            guess = previous_a[side] + shift / curvature
+                  - previous_cgf[side][3] * shift * shift / (2 * curvature * curvature * curvature);
+        }
+
+        double otm_price;
+        if (quadrature) {
+            // Beyond the edge saddlepoint approaches critical moment, any exponent of the strip gives the exact
+            // price, so integration stays on the edge line
+            double a;
+            Eigen::VectorXd cgf;
+            if (beyond_edge) {
+                a = edge_a[side];
+                cgf = edge_cgf[side];
+            } else {
+                a = saddlepoint_exponent(T, y, lower[side], upper[side], cgf, true, true, guess);
+                previous_a[side] = a;
+                previous_cgf[side] = cgf;
+            }
+            otm_price = damped_price(T, y, a, lower[side], upper[side], cgf);
+        } else if (beyond_edge && !std::isnan(edge_variance[side])) {
+            // Total implied variance is extrapolated by Lee slope (Benaim-Friz limit), normalised Black price
+            // of out-of-the-money option with x = -|y|
+            double v = std::sqrt(edge_variance[side] + slope[side] * (std::abs(y) - std::abs(edge_cgf[side][1])));
+            double x = -std::abs(y);
+            otm_price = std::exp(0.5 * y) * (
+                std::exp(0.5 * x) * normal_cdf(x / v + 0.5 * v) - std::exp(-0.5 * x) * normal_cdf(x / v - 0.5 * v)
+            );
+        } else {
+            Eigen::VectorXd cgf;
+            double a = saddlepoint_exponent(T, y, lower[side], upper[side], cgf, zero_pole, unit_pole, guess);
+            otm_price = lugannani_rice_price(y, a, side == 1, cgf);
+            previous_a[side] = a;
+            previous_cgf[side] = cgf;
+        }
+
+        // Undiscounted price per forward to option price, other type by Put-Call parity
+        result[j] = df(0, T) * forward * otm_price;
+        if (option.is_call() != (side == 1)) {
+            result[j] += (option.is_call() ? 1 : -1) * (s_0 - df(0, T) * strikes[j]);
+        }
+    }
+    return result;
+}
+
+void HestonEuropeanOptionCalculator::set_wing_moneyness(double moneyness)
+{
+    if (!(moneyness > 1)) {
+        throw std::invalid_argument("Wing moneyness must be greater than 1.");
+    }
+    wing_moneyness = moneyness;
+}
+
+double HestonEuropeanOptionCalculator::get_wing_moneyness()
+{
+    return wing_moneyness;
+}
+
+void HestonEuropeanOptionCalculator::set_wings_evaluation(WingsEvaluation evaluation)
+{
+    wings_evaluation = evaluation;
+}
+
+WingsEvaluation HestonEuropeanOptionCalculator::get_wings_evaluation()
+{
+    return wings_evaluation;
+}
 
-    // Calculate resulting call option prices
-    Eigen::RowVectorXd temp;
-    temp = (-alpha * log_strikes).array().exp();
-    result = integr_appr.real();
-    result = result.cwiseProduct(temp);
-    result = (df(0, T) * d_u / M_PI) * result;
-    
+UniformCubicSpline &HestonEuropeanOptionCalculator::normalised_surface(double T)
+{
+    std::tuple<double, double, double, double, double, double> key(
+        params.rho, params.kappa, params.theta, params.sigma, v_0, T
+    );
+    UniformCubicSpline *cached = surfaces_cache.find(key);
+    if (cached != NULL) {
+        return *cached;
+    }
+
+    // Call prices for unit spot on log strike grid, i.e. on log-moneyness grid
+    Eigen::RowVectorXcd exp_option_cf = integrand(T, 1.0);
+    exp_option_cf(Eigen::seq(1, N - 1, 2)) *= -1.0;
+    EuropeanOption option(true, T, 1.0);
+    Eigen::RowVectorXd prices = prices_from_transform(option, get_log_strike_grid(), fft(exp_option_cf));
+
+    UniformCubicSpline spline(-N * d_k / 2, d_k, prices);
+    return surfaces_cache.insert(key, spline);
+}
+
+Eigen::RowVectorXd HestonEuropeanOptionCalculator::calculate_from_surface(
+    EuropeanOption &option,
+    const Eigen::RowVectorXd &strikes
+) {
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    double T = option.get_maturity();
+    Eigen::RowVectorXd log_moneyness = (strikes / s_0).array().log();
+    if (!inside_grid(log_moneyness)) {
+        throw std::invalid_argument("Strikes must lie inside the log strike grid.");
+    }
+
+    // Rescale normalised prices by spot
+    Eigen::RowVectorXd result = s_0 * normalised_surface(T).evaluate(log_moneyness);
     if (option.is_call()) {
         return result;
     }
 
     // If option is of put type, use the Put-Call parity
-    return result.array() + log_strikes.array().exp() * df(0, T) - s_0;
+    return result.array() + strikes.array() * df(0, T) - s_0;
+}
+
+void HestonEuropeanOptionCalculator::clear_cache()
+{
+    coefficients_cache.clear();
+    surfaces_cache.clear();
+}
+
+void HestonEuropeanOptionCalculator::set_cache_capacity(int capacity)
+{
+    coefficients_cache.set_capacity(capacity);
+    surfaces_cache.set_capacity(capacity);
+}
+
+int HestonEuropeanOptionCalculator::get_cache_capacity()
+{
+    return coefficients_cache.get_capacity();
+}
+
+void HestonEuropeanOptionCalculator::set_strikes_evaluation(StrikesEvaluation evaluation)
+{
+    strikes_evaluation = evaluation;
+}
+
+StrikesEvaluation HestonEuropeanOptionCalculator::get_strikes_evaluation()
+{
+    return strikes_evaluation;
+}
+
+EuropeanOptionGreeks HestonEuropeanOptionCalculator::calculate_with_greeks(EuropeanOption &option, bool second_order)
+{
+    double T = option.get_maturity();
+    Eigen::RowVectorXcd psi = integrand(T);
+
+    // Char. function argument w = u - (alpha + 1)i and cached affine coefficient D(w, T)
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd w = carr_madan_arguments(alpha, N, d_u);
+    const Eigen::RowVectorXcd &D = affine_coefficients(T).second;
+    Eigen::ArrayXXcd i_w = i * w.array();
+
+    // Derivative of log char. function w.r.t. T at fixed x by Riccati equations
+    Eigen::ArrayXXcd d_T_log_cf = maturity_log_cf_derivative(T).array();
+
+    // Integrand multiplied by derivatives of char. function w.r.t. x, x twice, v and T,
+    // then w.r.t. x and v, v twice, x and T
+    Eigen::MatrixXcd stacked(second_order ? 8 : 5, N);
+    stacked.row(0) = psi;
+    stacked.row(1) = (i_w * psi.array()).matrix();
+    stacked.row(2) = (i_w * i_w * psi.array()).matrix();
+    stacked.row(3) = (D.array() * psi.array()).matrix();
+    stacked.row(4) = (d_T_log_cf * psi.array()).matrix();
+    if (second_order) {
+        stacked.row(5) = (i_w * D.array() * psi.array()).matrix();
+        stacked.row(6) = (D.array().square() * psi.array()).matrix();
+        stacked.row(7) = (i_w * d_T_log_cf * psi.array()).matrix();
+    }
+
+    // Alternate signs to shift log strikes grid to [-N*d_k/2, N*d_k/2)
+    stacked(Eigen::all, Eigen::seq(1, N - 1, 2)) *= -1.0;
+    Eigen::MatrixXcd transform = fft(stacked);
+
+    // Common factor of Carr-Madan formula
+    Eigen::RowVectorXd log_strikes = get_log_strike_grid();
+    Eigen::ArrayXXd factor = df(0, T) * carr_madan_damping(alpha, d_u, log_strikes).array();
+    Eigen::ArrayXXd price = factor * transform.row(0).real().array();
+    Eigen::ArrayXXd d_x = factor * transform.row(1).real().array();
+    Eigen::ArrayXXd d_xx = factor * transform.row(2).real().array();
+    Eigen::ArrayXXd d_T = factor * transform.row(4).real().array();
+
+    // Call option Greeks, x = ln(s_0) + rT
+    EuropeanOptionGreeks greeks;
+    greeks.price = price.matrix();
+    greeks.delta = (d_x / s_0).matrix();
+    greeks.gamma = ((d_xx - d_x) / (s_0 * s_0)).matrix();
+    greeks.vega = (factor * transform.row(3).real().array()).matrix();
+    greeks.theta = (r * price - d_T - r * d_x).matrix();
+    greeks.rho = (T * (d_x - price)).matrix();
+
+    // Delta and charm of put differ from call ones by a constant
+    if (second_order) {
+        Eigen::ArrayXXd d_xT = factor * transform.row(7).real().array();
+        greeks.vanna = (factor * transform.row(5).real().array() / s_0).matrix();
+        greeks.volga = (factor * transform.row(6).real().array()).matrix();
+        greeks.charm = ((r * d_x - d_xT - r * d_xx) / s_0).matrix();
+    }
+
+    if (option.is_call()) {
+        return greeks;
+    }
+
+    // If option is of put type, use the Put-Call parity
+    Eigen::ArrayXXd discounted_strikes = df(0, T) * log_strikes.array().exp();
+    greeks.price = (price + discounted_strikes - s_0).matrix();
+    greeks.delta = greeks.delta.array() - 1;
+    greeks.theta = (greeks.theta.array() + r * discounted_strikes).matrix();
+    greeks.rho = (greeks.rho.array() - T * discounted_strikes).matrix();
+    return greeks;
+}
+
+Eigen::MatrixXcd HestonEuropeanOptionCalculator::jacobian_integrands(double T)
+{
+    if (!integrate_condition(T).first) {
+        throw std::invalid_argument("Andersen-Piterbarg condition is false.");
+    }
+
+    // Char. function argument w = u - (alpha + 1)i, coefficients and gradient of log char. function
+    std::complex<double> i(0.0, 1.0);
+    Eigen::RowVectorXcd w = carr_madan_arguments(alpha, N, d_u);
+    Eigen::RowVectorXcd C, D;
+    Eigen::MatrixXcd gradient;
+    heston_cf_gradient(w, T, v_0, params, C, D, gradient);
+    if (jumps.lambda > 0) {
+        // Dependence of variance jumps part on Heston parameteres is not differentiated
+        Eigen::RowVectorXcd J;
+        svjj_jump_coefficient(w, T, params, jumps, jump_transform, J);
+        C += J;
+    }
+
+    // Carr-Madan integrand from the same coefficients and weights as integrand()
+    double x = std::log(s_0 * df(T, 0));
+    Eigen::RowVectorXcd psi = (
+        (C.array() + D.array() * v_0 + (i * x) * w.array()).exp() * integrand_weights.array()
+    ).matrix();
+
+    // Integrand multiplied by every derivative of log char. function
+    Eigen::MatrixXcd result(6, N);
+    result.row(0) = psi;
+    result.bottomRows(5) = (gradient.array().rowwise() * psi.array()).matrix();
+    return result;
+}
+
+bool HestonEuropeanOptionCalculator::inside_grid(const Eigen::RowVectorXd &log_strikes)
+{
+    return (log_strikes.cols() == 0) || (
+        (log_strikes.minCoeff() >= -N * d_k / 2) && (log_strikes.maxCoeff() <= (N / 2 - 1) * d_k)
+    );
+}
+
+Eigen::MatrixXd HestonEuropeanOptionCalculator::calculate_jacobian(EuropeanOption &option)
+{
+    double T = option.get_maturity();
+    Eigen::MatrixXcd stacked = jacobian_integrands(T).bottomRows(5);
+
+    // Alternate signs to shift log strikes grid to [-N*d_k/2, N*d_k/2)
+    stacked(Eigen::all, Eigen::seq(1, N - 1, 2)) *= -1.0;
+    Eigen::MatrixXcd transform = fft(stacked);
+
+    Eigen::RowVectorXd factor = df(0, T) * carr_madan_damping(alpha, d_u, get_log_strike_grid());
+    return (transform.real().array().rowwise() * factor.array()).matrix().transpose();
+}
+
+Eigen::MatrixXd HestonEuropeanOptionCalculator::calculate_jacobian_at(
+    EuropeanOption &option,
+    const Eigen::RowVectorXd &strikes,
+    Eigen::RowVectorXd &prices
+) {
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    Eigen::RowVectorXd log_strikes = strikes.array().log();
+    if ((strikes_evaluation == NUFFT_EVALUATION) && !inside_grid(log_strikes)) {
+        throw std::invalid_argument("Strikes must lie inside the log strike grid.");
+    }
+    double T = option.get_maturity();
+    Eigen::MatrixXcd stacked = jacobian_integrands(T);
+
+    // Scaled real parts of Carr-Madan sums of every row at given strikes
+    Eigen::MatrixXd sums(6, strikes.cols());
+    if (strikes_evaluation == SPLINE_EVALUATION) {
+        stacked(Eigen::all, Eigen::seq(1, N - 1, 2)) *= -1.0;
+        Eigen::MatrixXcd transform = fft(stacked);
+        Eigen::RowVectorXd factor = df(0, T) * carr_madan_damping(alpha, d_u, get_log_strike_grid());
+        for (int row=0; row<6; row++) {
+            Eigen::RowVectorXd values = transform.row(row).real().cwiseProduct(factor);
+            sums.row(row) = UniformCubicSpline(-N * d_k / 2, d_k, values).evaluate(log_strikes);
+        }
+    } else {
+        Eigen::RowVectorXd factor = df(0, T) * carr_madan_damping(alpha, d_u, log_strikes);
+        for (int row=0; row<6; row++) {
+            Eigen::RowVectorXcd transform = (strikes_evaluation == NUFFT_EVALUATION) ?
+                nufft(stacked.row(row), d_u * log_strikes) : goertzel(stacked.row(row), d_u * log_strikes);
+            sums.row(row) = transform.real().cwiseProduct(factor);
+        }
+    }
+
+    prices = sums.row(0);
+    if (!option.is_call()) {
+        // If option is of put type, use the Put-Call parity
+        prices = prices.array() + strikes.array() * df(0, T) - s_0;
+    }
+    return sums.bottomRows(5).transpose();
 }
@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @brief Interpolation on uniform grids.
+ */
+#include "interpolation.h"
+
+//! Points within this count of ulps outside of grid are moved to its end nodes.
+#define RANGE_TOLERANCE_ULPS 4
+
+UniformCubicSpline::UniformCubicSpline(double _x_0, double _h, const Eigen::RowVectorXd &_values)
+{
+    if (_h <= 0) {
+        throw std::invalid_argument("Grid step must be non-negative.");
+    }
+    if (_values.cols() < 3) {
+        throw std::invalid_argument("Grid must contain at least 3 nodes.");
+    }
+    x_0 = _x_0; h = _h; values = _values;
+
+    // Natural spline: M_{i-1} + 4M_i + M_{i+1} = 6(y_{i+1} - 2y_i + y_{i-1})/h^2, M_0 = M_{n-1} = 0
+    int n = values.cols();
+    second_derivatives = Eigen::RowVectorXd::Zero(n);
+    Eigen::RowVectorXd rhs = (6 / (h * h)) * (
+        values.segment(2, n - 2) - 2 * values.segment(1, n - 2) + values.segment(0, n - 2)
+    );
+
+    // Thomas algorithm for tridiagonal system with constant diagonals (1, 4, 1)
+    Eigen::RowVectorXd c(n - 2);
+    c[0] = 0.25;
+    rhs[0] /= 4;
+    for (int i=1; i<n-2; i++) {
+        double denominator = 4 - c[i - 1];
+        c[i] = 1 / denominator;
+        rhs[i] = (rhs[i] - rhs[i - 1]) / denominator;
+    }
+    second_derivatives[n - 2] = rhs[n - 3];
+    for (int i=n-4; i>=0; i--) {
+        second_derivatives[i + 1] = rhs[i] - c[i] * second_derivatives[i + 2];
+    }
+}
+
+double UniformCubicSpline::get_lower()
+{
+    return x_0;
+}
+
+double UniformCubicSpline::get_upper()
+{
+    return x_0 + (values.cols() - 1) * h;
+}
+
+Eigen::RowVectorXd UniformCubicSpline::evaluate(const Eigen::RowVectorXd &x)
+{
+    // End nodes recomputed from a grid (e.g. exponent and logarithm of log strikes) may be off by a few ulps
+    double lower = get_lower();
+    double upper = get_upper();
+    double slack = RANGE_TOLERANCE_ULPS * std::numeric_limits<double>::epsilon() *
+        std::max(h, std::max(std::abs(lower), std::abs(upper)));
+    if ((x.cols() > 0) && ((x.minCoeff() < lower - slack) || (x.maxCoeff() > upper + slack))) {
+        throw std::invalid_argument("Interpolation points must lie inside the grid.");
+    }
+
+    // Interval indices by direct division, the last node belongs to the last interval
+    Eigen::ArrayXd position = ((x.array().max(lower).min(upper) - x_0) / h).transpose();
+    Eigen::ArrayXi index = position.floor().cast<int>().min(values.cols() - 2);
+    Eigen::ArrayXd t = position - index.cast<double>();
+    Eigen::ArrayXd s = 1 - t;
+
+    Eigen::ArrayXd y_left = values(index).transpose();
+    Eigen::ArrayXd y_right = values(index + 1).transpose();
+    Eigen::ArrayXd m_left = second_derivatives(index).transpose();
+    Eigen::ArrayXd m_right = second_derivatives(index + 1).transpose();
+
+    return (
+        s * y_left + t * y_right +
+        (h * h / 6) * ((s.cube() - s) * m_left + (t.cube() - t) * m_right)
+    ).transpose();
+}
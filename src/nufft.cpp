@@ -0,0 +1,53 @@
+/**
+ * @file
+ * @brief Non-uniform FFT algorithm implementation.
+ */
+#include "nufft.h"
+
+//! Oversampling ratio of the FFT grid.
+#define NUFFT_OVERSAMPLING 2
+
+//! Count of grid points on each side of a target point used for spreading.
+#define NUFFT_SPREAD 12
+
+Eigen::RowVectorXcd nufft(const Eigen::RowVectorXcd &coefficients, const Eigen::RowVectorXd &phases)
+{
+    int N = coefficients.cols();
+    int grid_size = NUFFT_OVERSAMPLING * N;
+    Eigen::RowVectorXcd result = Eigen::RowVectorXcd::Zero(phases.cols());
+    if (N == 0) {
+        return result;
+    }
+
+    // Gaussian kernel exp(-x^2/(4*tau)) width by Greengard-Lee
+    double R = NUFFT_OVERSAMPLING;
+    double tau = M_PI * NUFFT_SPREAD / ((double)N * N * R * (R - 0.5));
+
+    // Center modes, sum_n f_n e^{-in theta} = e^{-is theta} sum_q f_{s-q} e^{iq theta}, q = s - n,
+    // and divide them by kernel Fourier coefficients sqrt(tau/pi)*exp(-q^2*tau)
+    int shift = N / 2;
+    Eigen::RowVectorXcd deconvolved = Eigen::RowVectorXcd::Zero(grid_size);
+    for (int n=0; n<N; n++) {
+        int q = shift - n;
+        deconvolved[(q + grid_size) % grid_size] = coefficients[n] * std::sqrt(M_PI / tau) * std::exp(q * q * tau);
+    }
+
+    // Values on oversampled grid y_m = 2*pi*m/grid_size, h_m = sum_q b_q e^{iq y_m}
+    deconvolved = deconvolved.conjugate();
+    Eigen::RowVectorXcd convolved = fft(deconvolved).conjugate();
+
+    // Spread Gaussian kernel back to every point
+    double h = 2 * M_PI / grid_size;
+    std::complex<double> i(0.0, 1.0);
+    for (int j=0; j<phases.cols(); j++) {
+        double x = phases[j] - 2 * M_PI * std::floor(phases[j] / (2 * M_PI));
+        int nearest = (int)std::floor(x / h);
+        std::complex<double> sum(0.0, 0.0);
+        for (int m=nearest-NUFFT_SPREAD+1; m<=nearest+NUFFT_SPREAD; m++) {
+            double distance = x - m * h;
+            sum += convolved[((m % grid_size) + grid_size) % grid_size] * std::exp(-distance * distance / (4 * tau));
+        }
+        result[j] = std::exp(-i * (shift * phases[j])) * sum / (double)grid_size;
+    }
+    return result;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @brief Heston model with piecewise constant parameteres policy of FourierPricer.
+ */
+#include "piecewise_heston.h"
+
+PiecewiseHestonModel::PiecewiseHestonModel(
+    const std::vector<double> &_times,
+    const std::vector<HestonParams> &_params,
+    double _v_0
+) {
+    for (int j=0; j<(int)_times.size(); j++) {
+        if ((_times[j] <= 0) || ((j > 0) && (_times[j] <= _times[j - 1]))) {
+            throw std::invalid_argument("Interval ends must be positive and increasing.");
+        }
+    }
+    if (_params.size() != _times.size() + 1) {
+        throw std::invalid_argument("Parameteres count must be interval ends count plus one.");
+    }
+    times = _times;
+    params = _params;
+    set_v0(_v_0);
+    prepared.assign(params.size(), false);
+    b_minus_d.resize(params.size());
+    d.resize(params.size());
+    propagation.resize(times.size());
+}
+
+void PiecewiseHestonModel::check_interval(int interval)
+{
+    if ((interval < 0) || (interval >= (int)params.size())) {
+        throw std::invalid_argument("Interval index must be in [0, intervals count).");
+    }
+}
+
+void PiecewiseHestonModel::prepare_interval(int interval)
+{
+    // Terms of heston_cf_coefficients() which do not depend on maturity, b = kappa - rho*sigma*iu
+    const HestonParams &p = params[interval];
+    Eigen::ArrayXXcd b = p.kappa - (p.rho * p.sigma) * i_u.array();
+    d[interval] = (b.square() + (p.sigma * p.sigma) * i_u_u2.array()).sqrt().matrix();
+    b_minus_d[interval] = (b - d[interval].array()).matrix();
+    if (interval < (int)times.size()) {
+        double start = (interval > 0) ? times[interval - 1] : 0;
+        interval_propagation(interval, times[interval] - start, propagation[interval]);
+    }
+    prepared[interval] = true;
+}
+
+void PiecewiseHestonModel::interval_propagation(int interval, double tau, HestonPropagation &result)
+{
+    const HestonParams &p = params[interval];
+    double sigma_2 = p.sigma * p.sigma;
+    Eigen::ArrayXXcd exp_d = (-tau * d[interval].array()).exp();
+    Eigen::ArrayXXcd two_d = 2.0 * d[interval].array();
+    Eigen::ArrayXXcd b_plus_d = b_minus_d[interval].array() + two_d;
+    result.level = ((b_plus_d - b_minus_d[interval].array() * exp_d) / two_d).matrix();
+    result.slope = (sigma_2 * (1.0 - exp_d) / two_d).matrix();
+    result.numerator = (-i_u_u2.array() * (1.0 - exp_d) / two_d).matrix();
+    result.feedback = ((b_minus_d[interval].array() - b_plus_d * exp_d) / two_d).matrix();
+    result.drift = ((p.kappa * p.theta * tau / sigma_2) * b_minus_d[interval].array()).matrix();
+}
+
+void PiecewiseHestonModel::log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result)
+{
+    if ((grid.cols() != u.cols()) || (grid != u)) {
+        std::complex<double> i(0.0, 1.0);
+        grid = u;
+        i_u = (i * u.array()).matrix();
+        i_u_u2 = (i_u.array() + u.array().square()).matrix();
+        prepared.assign(params.size(), false);
+        cf_cache.clear();
+    }
+    Eigen::RowVectorXcd *cached = cf_cache.find(T);
+    if (cached != NULL) {
+        result = *cached;
+        return;
+    }
+
+    // Interval (t_{k-1}, t_k] contains T, it is propagated partially unless T is its end
+    int last = std::lower_bound(times.begin(), times.end(), T) - times.begin();
+    for (int j=0; j<=last; j++) {
+        if (!prepared[j]) {
+            prepare_interval(j);
+        }
+    }
+    HestonPropagation partial;
+    double start = (last > 0) ? times[last - 1] : 0;
+    if ((last == (int)times.size()) || (T < times[last])) {
+        interval_propagation(last, T - start, partial);
+    }
+
+    // Backward recursion from maturity, C and D start at zero
+    Eigen::ArrayXXcd C = Eigen::ArrayXXcd::Zero(1, u.cols());
+    Eigen::ArrayXXcd D = Eigen::ArrayXXcd::Zero(1, u.cols());
+    for (int j=last; j>=0; j--) {
+        const HestonPropagation &step = ((j == last) && (partial.level.cols() > 0)) ? partial : propagation[j];
+        const HestonParams &p = params[j];
+        Eigen::ArrayXXcd denominator = step.level.array() - step.slope.array() * D;
+        C += step.drift.array() - (2 * p.kappa * p.theta / (p.sigma * p.sigma)) * denominator.log();
+        D = (step.numerator.array() - step.feedback.array() * D) / denominator;
+    }
+    result = (C + v_0 * D).matrix();
+    cf_cache.insert(T, result);
+}
+
+std::pair<double, double> PiecewiseHestonModel::moment_strip(double T)
+{
+    return piecewise_heston_critical_moments(T, times, params);
+}
+
+void PiecewiseHestonModel::set_params(int interval, const HestonParams &_params)
+{
+    check_interval(interval);
+    params[interval] = _params;
+    prepared[interval] = false;
+    cf_cache.clear();
+}
+
+HestonParams PiecewiseHestonModel::get_params(int interval)
+{
+    check_interval(interval);
+    return params[interval];
+}
+
+std::vector<double> PiecewiseHestonModel::get_times()
+{
+    return times;
+}
+
+void PiecewiseHestonModel::set_v0(double _v_0)
+{
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0 = _v_0;
+    cf_cache.clear();
+}
+
+double PiecewiseHestonModel::get_v0()
+{
+    return v_0;
+}
+
+void PiecewiseHestonModel::clear_cache()
+{
+    grid.resize(0);
+    prepared.assign(params.size(), false);
+    cf_cache.clear();
+}
@@ -0,0 +1,336 @@
+/**
+ * @file
+ * @brief Pricing engine choosing the cheapest Heston pricing method for a request.
+ */
+#include "pricing_engine.h"
+
+//! COS method truncation range width in standard deviations.
+#define COS_TRUNCATION_WIDTH 12
+
+//! Smallest and largest COS series terms count.
+#define COS_MIN_TERMS 32
+#define COS_MAX_TERMS 4096
+
+//! Smallest and largest Gauss-Laguerre nodes count.
+#define LEWIS_MIN_NODES 8
+#define LEWIS_MAX_NODES 128
+
+//! Smallest convergence ratio of Gauss-Laguerre quadrature assumed for Lewis formula.
+#define LEWIS_MIN_RATIO 0.6
+
+//! Relative accuracy of nufft() w.r.t. sum of absolute values of coefficients.
+#define NUFFT_ACCURACY 1e-13
+
+PricingEngine::PricingEngine(
+    double _r,
+    double _s_0,
+    double _v_0,
+    HestonParams &_params,
+    double alpha,
+    int N,
+    double d_u,
+    double _tolerance
+) :
+    fft_calculator(_r, _s_0, _v_0, _params, alpha, N, d_u),
+    cos_calculator(_r, _s_0, _v_0, _params, COS_MIN_TERMS, COS_TRUNCATION_WIDTH),
+    lewis_calculator(_r, _s_0, _v_0, _params, LEWIS_MIN_NODES)
+{
+    r = _r; s_0 = _s_0; v_0 = _v_0; params = _params;
+    set_tolerance(_tolerance);
+
+    // Rough constants of a modern CPU, see calibrate_cost_model()
+    costs.char_function = 1.5e-7;
+    costs.fft = 3e-9;
+    costs.recurrence = 2e-9;
+    costs.cos_term = 3e-8;
+    costs.lewis_term = 2e-8;
+    costs.interpolation = 1e-8;
+}
+
+double PricingEngine::df(double t, double T)
+{
+    return std::exp(-r * (T-t));
+}
+
+void PricingEngine::set_tolerance(double _tolerance)
+{
+    if (_tolerance <= 0) {
+        throw std::invalid_argument("Tolerance must be non-negative.");
+    }
+    tolerance = _tolerance;
+}
+
+double PricingEngine::get_tolerance()
+{
+    return tolerance;
+}
+
+void PricingEngine::set_costs(const PricingCosts &_costs)
+{
+    if ((_costs.char_function <= 0) || (_costs.fft <= 0) || (_costs.recurrence <= 0) ||
+        (_costs.cos_term <= 0) || (_costs.lewis_term <= 0) || (_costs.interpolation <= 0)) {
+        throw std::invalid_argument("Cost model constants must be non-negative.");
+    }
+    costs = _costs;
+}
+
+PricingCosts PricingEngine::get_costs()
+{
+    return costs;
+}
+
+/**
+ * @brief           Measure average time of a function call
+ *
+ * @details         Function is called once to warm up caches, then it is repeated
+ *                  at least 3 times and until at least a millisecond is elapsed.
+ *
+ * @param   function    Callable object without arguments
+ *
+ * @return          time in seconds.
+ */
+template <typename Function>
+static double seconds_per_call(Function function)
+{
+    function();
+    int repeats = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed(0);
+    while ((repeats < 3) || (elapsed.count() < 1e-3)) {
+        function();
+        repeats++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    return elapsed.count() / repeats;
+}
+
+PricingCosts PricingEngine::calibrate_cost_model()
+{
+    int n = 4096;
+    int m = 64;
+    Eigen::RowVectorXcd u = Eigen::RowVectorXd::LinSpaced(n, 0, (n - 1) * 0.1);
+    Eigen::RowVectorXcd vector = Eigen::RowVectorXcd::Random(n);
+    Eigen::RowVectorXd phases = Eigen::RowVectorXd::Random(m);
+    Eigen::RowVectorXd strikes = s_0 * Eigen::RowVectorXd::LinSpaced(m, 0.5, 2.0);
+    EuropeanOption option(true, 1, s_0);
+    Eigen::RowVectorXd values = Eigen::RowVectorXd::Random(n);
+    Eigen::RowVectorXd points = Eigen::RowVectorXd::LinSpaced(n, 0, n - 1);
+    double alpha = fft_calculator.get_alpha();
+
+    PricingCosts measured;
+    measured.char_function = seconds_per_call([&]() {
+        heston_exp_option_cf(u, 0, v_0, alpha, 1, params);
+    }) / n;
+    measured.fft = seconds_per_call([&]() {
+        fft(vector);
+    }) / (n * std::log2(n));
+    measured.recurrence = seconds_per_call([&]() {
+        goertzel(vector, phases);
+    }) / (n * m);
+
+    // COS method evaluates char. function on every call, Lewis formula caches it per maturity
+    cos_calculator.set_calculator_params(n / 16, COS_TRUNCATION_WIDTH);
+    measured.cos_term = seconds_per_call([&]() {
+        cos_calculator.calculate(option, strikes);
+    }) / (n / 16 * m) - measured.char_function / m;
+    measured.cos_term = std::max(measured.cos_term, measured.recurrence);
+    lewis_calculator.set_calculator_params(LEWIS_MAX_NODES);
+    measured.lewis_term = seconds_per_call([&]() {
+        lewis_calculator.calculate(option, strikes);
+    }) / (LEWIS_MAX_NODES * m);
+    measured.interpolation = seconds_per_call([&]() {
+        UniformCubicSpline(0, 1, values).evaluate(points);
+    }) / (2 * n);
+
+    set_costs(measured);
+    return costs;
+}
+
+double PricingEngine::carr_madan_error(double T, const Eigen::RowVectorXd &log_strikes)
+{
+    if (!fft_calculator.integrate_condition(T).first) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double alpha = fft_calculator.get_alpha();
+    double d_u = fft_calculator.get_d_u();
+    double u_max = fft_calculator.get_N() * d_u;
+    double damping = std::exp(-alpha * log_strikes.minCoeff());
+
+    // Integrand decays at least as u^-2, so its tail integral is bounded by |psi(U)|U
+    double x = std::log(s_0 / df(0, T));
+    double tail = std::abs(heston_exp_option_cf(u_max, x, v_0, alpha, T, params)) * u_max / M_PI;
+
+    // Nearest periodic image of damped call price is e^{alpha(k - 2pi/d_u)} F
+    double aliasing = std::exp(x - 2 * M_PI * alpha / d_u);
+
+    return df(0, T) * damping * tail + s_0 * aliasing;
+}
+
+double PricingEngine::series_error(PricingMethod method, int size, double T, const Eigen::RowVectorXd &strikes)
+{
+    if (strikes.cols() == 0) {
+        return 0;
+    }
+    double F = s_0 / df(0, T);
+    double K = strikes.maxCoeff();
+    std::complex<double> i(0.0, 1.0);
+
+    if (method == COS_METHOD) {
+        // Series tail is driven by char. function at the cut-off frequency, range tail by normal tail
+        std::pair<double, double> range = cos_calculator.get_truncation_range(T);
+        double u_max = size * M_PI / (range.second - range.first);
+        double series = std::abs(heston_log_price_cf(u_max, 0, v_0, 0, T, params));
+        double truncation = std::erfc(COS_TRUNCATION_WIDTH / std::sqrt(2.0));
+        return df(0, T) * std::max(F, K) * (series + truncation);
+    }
+
+    // Gauss-Laguerre error for e^{-sx} integrand decays as |s/(2+s)|^{2n}, where char. function decays as
+    // e^{-cu}, u = scale*x, and strikes add oscillation; small-u Gaussian part of char. function limits the rate
+    double scale = lewis_calculator.get_node_scale(T);
+    double c = std::sqrt(1 - params.rho * params.rho) * (v_0 + params.kappa * params.theta * T) / params.sigma;
+    double omega = scale * std::max(std::abs(std::log(F / K)), std::abs(std::log(F / strikes.minCoeff())));
+    std::complex<double> s = c * scale - 1.0 - i * omega;
+    double ratio = std::max(std::abs(s / (2.0 + s)), LEWIS_MIN_RATIO);
+    return df(0, T) * std::sqrt(F * K) / M_PI * std::pow(ratio, 2 * size);
+}
+
+int PricingEngine::series_size(PricingMethod method, double T, const Eigen::RowVectorXd &strikes)
+{
+    if ((method != COS_METHOD) && (method != LEWIS_METHOD)) {
+        return 0;
+    }
+    int size = (method == COS_METHOD) ? COS_MIN_TERMS : LEWIS_MIN_NODES;
+    int max_size = (method == COS_METHOD) ? COS_MAX_TERMS : LEWIS_MAX_NODES;
+    while ((size < max_size) && (series_error(method, size, T, strikes) > tolerance)) {
+        size *= 2;
+    }
+    return size;
+}
+
+double PricingEngine::estimate_cost(PricingMethod method, EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    double m = strikes.cols();
+    double N = fft_calculator.get_N();
+    double n;
+
+    switch (method) {
+        case FFT_SPLINE_METHOD:
+            return costs.char_function * N + costs.fft * N * std::log2(N) + costs.interpolation * (N + m);
+        case FFT_NUFFT_METHOD:
+            return costs.char_function * N + costs.fft * 2 * N * std::log2(2 * N) + costs.interpolation * 24 * m;
+        case DIRECT_METHOD:
+            return costs.char_function * N + costs.recurrence * N * m;
+        case COS_METHOD:
+            n = series_size(method, option.get_maturity(), strikes);
+            return costs.char_function * n + costs.cos_term * n * m;
+        default:
+            n = series_size(method, option.get_maturity(), strikes);
+            return costs.char_function * n + costs.lewis_term * n * m;
+    }
+}
+
+double PricingEngine::estimate_error(PricingMethod method, EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    if ((strikes.cols() > 0) && (strikes.minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be non-negative.");
+    }
+    if (strikes.cols() == 0) {
+        return 0;
+    }
+    double T = option.get_maturity();
+    Eigen::RowVectorXd log_strikes = strikes.array().log();
+
+    if ((method == COS_METHOD) || (method == LEWIS_METHOD)) {
+        return series_error(method, series_size(method, T, strikes), T, strikes);
+    }
+    double error = carr_madan_error(T, log_strikes);
+    if (method == DIRECT_METHOD) {
+        return error;
+    }
+
+    // Spline and NUFFT evaluate only inside the log strike grid
+    Eigen::RowVectorXd grid = fft_calculator.get_log_strike_grid();
+    if ((log_strikes.minCoeff() < grid[0]) || (log_strikes.maxCoeff() > grid[grid.cols() - 1])) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double F = s_0 / df(0, T);
+    if (method == FFT_NUFFT_METHOD) {
+        // Sum of absolute values of Carr-Madan terms is bounded by N*psi(0)
+        double alpha = fft_calculator.get_alpha();
+        double psi_0 = std::abs(heston_exp_option_cf(0, std::log(F), v_0, alpha, T, params));
+        double terms = fft_calculator.get_N() * fft_calculator.get_d_u() / M_PI * psi_0;
+        return error + NUFFT_ACCURACY * df(0, T) * std::exp(-alpha * log_strikes.minCoeff()) * terms;
+    }
+
+    // Fourth log strike derivative of price is about F/sqrt(2pi w^3) for total variance w
+    double e_1 = std::exp(-params.kappa * T);
+    double variance = (params.theta + (v_0 - params.theta) * (1 - e_1) / (params.kappa * T)) * T;
+    double d_k = fft_calculator.get_d_k();
+    double derivative = df(0, T) * F / std::sqrt(2 * M_PI * variance * variance * variance);
+    return error + 5.0 / 384 * std::pow(d_k, 4) * derivative;
+}
+
+PricingMethod PricingEngine::choose_method(EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    // Nothing is evaluated without strikes, and error estimates need at least one of them
+    if (strikes.cols() == 0) {
+        return DIRECT_METHOD;
+    }
+    PricingMethod best = FFT_SPLINE_METHOD;
+    double best_cost = std::numeric_limits<double>::infinity();
+    PricingMethod most_accurate = FFT_SPLINE_METHOD;
+    double best_error = std::numeric_limits<double>::infinity();
+
+    for (int index=FFT_SPLINE_METHOD; index<=LEWIS_METHOD; index++) {
+        PricingMethod method = (PricingMethod)index;
+        double error = estimate_error(method, option, strikes);
+        if (error < best_error) {
+            best_error = error;
+            most_accurate = method;
+        }
+        if (error > tolerance) {
+            continue;
+        }
+        double cost = estimate_cost(method, option, strikes);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = method;
+        }
+    }
+
+    // Fallback to the most accurate method if tolerance is not reachable
+    if (best_cost == std::numeric_limits<double>::infinity()) {
+        return most_accurate;
+    }
+    return best;
+}
+
+Eigen::RowVectorXd PricingEngine::calculate(EuropeanOption &option, const Eigen::RowVectorXd &strikes)
+{
+    if (strikes.cols() == 0) {
+        return Eigen::RowVectorXd(0);
+    }
+    PricingMethod method = choose_method(option, strikes);
+    int size = series_size(method, option.get_maturity(), strikes);
+
+    switch (method) {
+        case FFT_SPLINE_METHOD:
+            fft_calculator.set_strikes_evaluation(SPLINE_EVALUATION);
+            return fft_calculator.calculate_at(option, strikes);
+        case FFT_NUFFT_METHOD:
+            fft_calculator.set_strikes_evaluation(NUFFT_EVALUATION);
+            return fft_calculator.calculate_at(option, strikes);
+        case DIRECT_METHOD:
+            fft_calculator.set_strikes_evaluation(DIRECT_EVALUATION);
+            return fft_calculator.calculate_at(option, strikes);
+        case COS_METHOD:
+            cos_calculator.set_calculator_params(size, COS_TRUNCATION_WIDTH);
+            return cos_calculator.calculate(option, strikes);
+        default:
+            // Gauss-Laguerre nodes are recalculated only if their count changes
+            if (lewis_calculator.get_N() != size) {
+                lewis_calculator.set_calculator_params(size);
+            }
+            return lewis_calculator.calculate(option, strikes);
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @brief Gaussian quadrature rules.
+ */
+#include "quadrature.h"
+
+/**
+ * @brief           Evaluate Laguerre polynomials \f$ L_{n-1}(x), L_n(x) \f$ by three-term recurrence
+ */
+static void laguerre(int n, double x, double &l_prev, double &l_n)
+{
+    l_prev = 1;
+    l_n = 1 - x;
+    for (int k=1; k<n; k++) {
+        double l_next = ((2 * k + 1 - x) * l_n - k * l_prev) / (k + 1);
+        l_prev = l_n;
+        l_n = l_next;
+    }
+}
+
+/**
+ * @brief           Evaluate Legendre polynomial \f$ P_n(x) \f$ and its derivative by three-term recurrence
+ */
+static void legendre(int n, double x, double &p_n, double &derivative)
+{
+    double p_prev = 1;
+    p_n = x;
+    for (int k=1; k<n; k++) {
+        double p_next = ((2 * k + 1) * x * p_n - k * p_prev) / (k + 1);
+        p_prev = p_n;
+        p_n = p_next;
+    }
+    derivative = n * (x * p_n - p_prev) / (x * x - 1);
+}
+
+void gauss_laguerre(int n, Eigen::RowVectorXd &nodes, Eigen::RowVectorXd &weights)
+{
+    if ((n <= 0) || (n > 128)) {
+        throw std::invalid_argument("Nodes count must be non-negative and not greater than 128.");
+    }
+
+    // Jacobi matrix of Laguerre polynomials
+    Eigen::MatrixXd jacobi = Eigen::MatrixXd::Zero(n, n);
+    for (int k=0; k<n; k++) {
+        jacobi(k, k) = 2 * k + 1;
+        if (k > 0) {
+            jacobi(k, k - 1) = k;
+            jacobi(k - 1, k) = k;
+        }
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(jacobi, Eigen::EigenvaluesOnly);
+    nodes = solver.eigenvalues().transpose();
+    weights.resize(n);
+
+    double l_prev, l_n;
+    for (int k=0; k<n; k++) {
+        // Refine node by Newton steps, L_n'(x) = n(L_n(x) - L_{n-1}(x))/x
+        double x = nodes[k];
+        for (int step=0; step<3; step++) {
+            laguerre(n, x, l_prev, l_n);
+            x -= l_n * x / (n * (l_n - l_prev));
+        }
+        nodes[k] = x;
+
+        // Weight is calculated in log scale, since L_{n+1}(x) grows fast
+        laguerre(n + 1, x, l_prev, l_n);
+        weights[k] = std::exp(x + std::log(x) - 2 * std::log(std::abs((n + 1) * l_n)));
+    }
+}
+
+void gauss_legendre(int n, Eigen::RowVectorXd &nodes, Eigen::RowVectorXd &weights)
+{
+    if (n <= 0) {
+        throw std::invalid_argument("Nodes count must be non-negative.");
+    }
+
+    // Jacobi matrix of Legendre polynomials
+    Eigen::MatrixXd jacobi = Eigen::MatrixXd::Zero(n, n);
+    for (int k=1; k<n; k++) {
+        jacobi(k, k - 1) = k / std::sqrt(4.0 * k * k - 1);
+        jacobi(k - 1, k) = jacobi(k, k - 1);
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(jacobi, Eigen::EigenvaluesOnly);
+    nodes = solver.eigenvalues().transpose();
+    weights.resize(n);
+
+    double p_n, derivative;
+    for (int k=0; k<n; k++) {
+        // Refine node by Newton steps
+        double x = nodes[k];
+        for (int step=0; step<3; step++) {
+            legendre(n, x, p_n, derivative);
+            x -= p_n / derivative;
+        }
+        nodes[k] = x;
+        legendre(n, x, p_n, derivative);
+        weights[k] = 2 / ((1 - x * x) * derivative * derivative);
+    }
+}
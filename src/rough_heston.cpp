@@ -0,0 +1,452 @@
+/**
+ * @file
+ * @brief Rough Heston model policy of FourierPricer by multi-factor Markovian approximation.
+ */
+#include "rough_heston.h"
+#include "quadrature.h"
+
+//! Below this value of \f$ x\Delta \f$ relaxation weights are calculated by Taylor series.
+#define SERIES_THRESHOLD 1e-3
+
+//! Bounds \f$ x_0, x_1 \f$ of kernel Laplace measure integrated by Gauss-Legendre rule, kernel is accurate
+//! for \f$ 1/x_1 \ll t \ll 1/x_0 \f$.
+#define KERNEL_LOWER_NODE 1e-2
+#define KERNEL_UPPER_NODE 1e6
+
+//! Modulus of Riccati solution at which moment is considered exploded.
+#define EXPLOSION_BOUND 1e8
+
+//! Doublings count of largest moment order searched (2^20 is about 1e6).
+#define MOMENT_DOUBLINGS 20
+
+//! Moment orders marched at once by every multisection pass and count of passes.
+#define MOMENT_SECTIONS 16
+#define MOMENT_PASSES 4
+
+//! Time grid is graded near zero, where solutions behave as \f$ t^{H+1/2} \f$: step is
+//! \f$ \min(\Delta, \max(10^{-3}\Delta, 0.1t)) \f$ for time step \f$ \Delta \f$.
+#define MIN_STEP_FRACTION 1e-3
+#define STEP_GRADING 0.1
+
+//! Count of arguments marched together, factor solutions of a block stay in cache during the march.
+#define BLOCK_COLUMNS 64
+
+/**
+ * @brief           Get Riccati function \f$ F = a + b\psi + \frac{\sigma^2}{2}\psi^2 \f$ of aggregated solution
+ */
+static Eigen::ArrayXXcd riccati_function(
+    const Eigen::ArrayXXcd &constant,
+    const Eigen::ArrayXXcd &linear,
+    double sigma_2,
+    const Eigen::ArrayXXcd &total
+) {
+    return constant + linear * total + (0.5 * sigma_2) * total.square();
+}
+
+/**
+ * @brief           Get steps of time grid from a node up to the last node not after T
+ *
+ * @param   start       Time of grid node
+ * @param   T           End time
+ * @param   time_step   Largest time step
+ * @param   steps       Output vector of steps
+ * @return              Time of the last node
+ */
+static double grid_steps(double start, double T, double time_step, std::vector<double> &steps)
+{
+    steps.clear();
+    double t = start;
+    while (true) {
+        double dt = std::min(time_step, std::max(MIN_STEP_FRACTION * time_step, STEP_GRADING * t));
+        if (t + dt > T) {
+            return t;
+        }
+        steps.push_back(dt);
+        t += dt;
+    }
+}
+
+/**
+ * @brief           Calculate relaxation weights of kernel factors for a time step
+ *
+ * @details         Solution of \f$ \psi_i' = -x_i\psi_i + F \f$ with F linear on the step is
+ *                  \f$ \psi_i(t+\Delta) = e^{-x_i\Delta}\psi_i(t) + \Delta(\varphi_1 - \varphi_2)F(t) + \Delta\varphi_2F(t+\Delta) \f$,
+ *                  \f$ \varphi_1(z) = \frac{1-e^{-z}}{z} \f$, \f$ \varphi_2(z) = \frac{z-1+e^{-z}}{z^2} \f$, \f$ z = x_i\Delta \f$.
+ *
+ * @param   nodes       Mean reversions \f$ x_i \f$ of factors
+ * @param   dt          Time step
+ * @param   decay       Output column of \f$ e^{-x_i\Delta} \f$
+ * @param   previous    Output column of weights of \f$ F(t) \f$
+ * @param   next        Output column of weights of \f$ F(t+\Delta) \f$
+ */
+static void relaxation_weights(
+    const Eigen::ArrayXd &nodes,
+    double dt,
+    Eigen::Ref<Eigen::ArrayXd> decay,
+    Eigen::Ref<Eigen::ArrayXd> previous,
+    Eigen::Ref<Eigen::ArrayXd> next
+) {
+    for (int i=0; i<nodes.rows(); i++) {
+        double z = nodes[i] * dt;
+        double phi_1, phi_2;
+        if (z < SERIES_THRESHOLD) {
+            phi_1 = 1 - z / 2 * (1 - z / 3 * (1 - z / 4 * (1 - z / 5)));
+            phi_2 = 0.5 - z / 6 * (1 - z / 4 * (1 - z / 5 * (1 - z / 6)));
+        } else {
+            phi_1 = -std::expm1(-z) / z;
+            phi_2 = (1 - phi_1) / z;
+        }
+        decay[i] = std::exp(-z);
+        previous[i] = dt * (phi_1 - phi_2);
+        next[i] = dt * phi_2;
+    }
+}
+
+/**
+ * @brief           March Riccati equations of kernel factors by exponential trapezoid steps
+ *
+ * @details         Linear parts of factor equations are integrated exactly and F is linear on a step, see
+ *                  relaxation_weights(). Then aggregated solution \f$ \psi = \sum_ic_i\psi_i \f$ at the step end solves
+ *                  \f$ \psi = q + \beta(a + b\psi + \frac{\sigma^2}{2}\psi^2) \f$, \f$ \beta = \Delta\sum_ic_i\varphi_2(x_i\Delta) \f$,
+ *                  whose root continuous at \f$ \beta = 0 \f$ is
+ *                  \f$ \psi = \frac{2(q+\beta a)}{s + \sqrt{s^2 - 2\beta\sigma^2(q+\beta a)}} \f$, \f$ s = 1 - \beta b \f$.
+ *                  Stiff factors are stable and cost nothing more than soft ones. For real arguments a column explodes
+ *                  if the equation has no real root or \f$ s \le 0 \f$ (the step crosses a pole), or if solution is not
+ *                  finite or exceeds the bound.
+ *
+ * @param   decay       Decays of factors by steps (factors x steps)
+ * @param   previous    Weights of F at step start by steps (factors x steps)
+ * @param   next        Weights of F at step end by steps (factors x steps)
+ */
+static void riccati_steps(
+    const Eigen::ArrayXXcd &constant,
+    const Eigen::ArrayXXcd &linear,
+    double sigma_2,
+    const Eigen::ArrayXd &weights,
+    const std::vector<double> &steps,
+    const Eigen::ArrayXXd &decay,
+    const Eigen::ArrayXXd &previous,
+    const Eigen::ArrayXXd &next,
+    Eigen::ArrayXXcd &psi,
+    Eigen::ArrayXXcd &riccati,
+    Eigen::ArrayXXcd &integral,
+    Eigen::Array<bool, 1, Eigen::Dynamic> &exploded
+) {
+    int columns = psi.cols();
+    Eigen::ArrayXXcd total(1, columns), shift(1, columns), root(1, columns), following(1, columns);
+
+    for (int step=0; step<(int)steps.size(); step++) {
+        // Known part of factor solutions at step end and its aggregation q
+        psi = (psi.colwise() * decay.col(step).cast<std::complex<double> >())
+            + (previous.col(step).cast<std::complex<double> >().matrix() * riccati.matrix()).array();
+        double beta = (weights * next.col(step)).sum();
+        total = (psi.colwise() * weights.cast<std::complex<double> >()).colwise().sum();
+
+        // Root of beta*sigma^2/2*psi^2 - s*psi + (q + beta*a) = 0 continuous at beta = 0
+        shift = 1.0 - beta * linear;
+        total += beta * constant;
+        root = (shift.square() - (2 * beta * sigma_2) * total).sqrt();
+        root = ((shift.conjugate() * root).real() < 0).select(-root, root);
+        exploded = exploded || ((root.real() == 0) && (total.real() != 0)).row(0) || (shift.real() <= 0).row(0);
+        total = 2.0 * total / (shift + root);
+
+        following = riccati_function(constant, linear, sigma_2, total);
+        psi += (next.col(step).cast<std::complex<double> >().matrix() * following.matrix()).array();
+
+        // Trapezoid rule of time integral of F
+        integral += (0.5 * steps[step]) * (riccati + following);
+        riccati = following;
+        exploded = exploded || !(total.abs() < EXPLOSION_BOUND).row(0);
+    }
+}
+
+RoughHestonModel::RoughHestonModel(
+    const HestonParams &_params,
+    double _hurst,
+    double _v_0,
+    int _factors,
+    double _time_step
+) {
+    params = _params;
+    threads_count = std::max(1, (int)std::thread::hardware_concurrency());
+    set_v0(_v_0);
+    if (!((_hurst > 0) && (_hurst < 0.5))) {
+        throw std::invalid_argument("Hurst exponent must be in (0, 1/2).");
+    }
+    hurst = _hurst;
+    set_discretization(_factors, _time_step);
+}
+
+void RoughHestonModel::set_kernel()
+{
+    // Laplace measure of kernel is sin(pi*alpha)/pi * x^(-alpha) dx, alpha = H + 1/2. Its mass on [0, x_0] is
+    // placed at its mean, on [x_0, x_1] substitution x = e^s gives smooth density sin(pi*alpha)/pi * e^((1-alpha)s)
+    // integrated by Gauss-Legendre rule of m - 1 nodes
+    double alpha = hurst + 0.5;
+    double density = std::sin(M_PI * alpha) / M_PI;
+    double lower = std::log(KERNEL_LOWER_NODE), upper = std::log(KERNEL_UPPER_NODE);
+    Eigen::RowVectorXd gauss_nodes, gauss_weights;
+    gauss_legendre(factors - 1, gauss_nodes, gauss_weights);
+    Eigen::ArrayXd s = 0.5 * (lower + upper) + 0.5 * (upper - lower) * gauss_nodes.transpose().array();
+
+    weights.resize(factors);
+    nodes.resize(factors);
+    weights[0] = density * std::pow(KERNEL_LOWER_NODE, 1 - alpha) / (1 - alpha);
+    nodes[0] = (1 - alpha) / (2 - alpha) * KERNEL_LOWER_NODE;
+    weights.tail(factors - 1) = (
+        density * 0.5 * (upper - lower) * gauss_weights.transpose().array() * ((1 - alpha) * s).exp()
+    );
+    nodes.tail(factors - 1) = s.exp();
+    reset();
+}
+
+void RoughHestonModel::reset()
+{
+    grid.resize(0);
+    time = 0;
+    cf_cache.clear();
+    strip_cache.clear();
+}
+
+void RoughHestonModel::advance(
+    const Eigen::ArrayXXcd &_constant,
+    const Eigen::ArrayXXcd &_linear,
+    const std::vector<double> &steps,
+    Eigen::ArrayXXcd &_psi,
+    Eigen::ArrayXXcd &_riccati,
+    Eigen::ArrayXXcd &_integral,
+    Eigen::Array<bool, 1, Eigen::Dynamic> &exploded
+) {
+    if (steps.empty()) {
+        return;
+    }
+
+    // Relaxation weights are shared by columns, blocks of columns are marched through all steps one by one
+    // and distributed among threads
+    int count = (int)steps.size();
+    Eigen::ArrayXXd decay(factors, count), previous(factors, count), next(factors, count);
+    for (int step=0; step<count; step++) {
+        relaxation_weights(nodes, steps[step], decay.col(step), previous.col(step), next.col(step));
+    }
+    int columns = _psi.cols();
+    int blocks = (columns + BLOCK_COLUMNS - 1) / BLOCK_COLUMNS;
+    double sigma_2 = params.sigma * params.sigma;
+    run_parallel(blocks, threads_count, [&](int block) {
+        int start = block * BLOCK_COLUMNS;
+        int size = std::min(BLOCK_COLUMNS, columns - start);
+        Eigen::ArrayXXcd block_psi = _psi.middleCols(start, size);
+        Eigen::ArrayXXcd block_riccati = _riccati.middleCols(start, size);
+        Eigen::ArrayXXcd block_integral = _integral.middleCols(start, size);
+        Eigen::Array<bool, 1, Eigen::Dynamic> block_exploded = exploded.segment(start, size);
+        riccati_steps(
+            _constant.middleCols(start, size), _linear.middleCols(start, size), sigma_2, weights,
+            steps, decay, previous, next, block_psi, block_riccati, block_integral, block_exploded
+        );
+        _psi.middleCols(start, size) = block_psi;
+        _riccati.middleCols(start, size) = block_riccati;
+        _integral.middleCols(start, size) = block_integral;
+        exploded.segment(start, size) = block_exploded;
+    });
+}
+
+void RoughHestonModel::log_cf(const Eigen::RowVectorXcd &u, double T, Eigen::RowVectorXcd &result)
+{
+    if ((grid.cols() != u.cols()) || (grid != u)) {
+        // F(u, 0) = (-u^2 - iu)/2 and linear term iu*rho*sigma - kappa, march starts at psi = 0
+        std::complex<double> i(0.0, 1.0);
+        grid = u;
+        constant = 0.5 * (-u.array().square() - i * u.array());
+        linear = (params.rho * params.sigma * i) * u.array() - params.kappa;
+        psi = Eigen::ArrayXXcd::Zero(factors, u.cols());
+        riccati = constant;
+        integral = Eigen::ArrayXXcd::Zero(1, u.cols());
+        time = 0;
+        cf_cache.clear();
+    }
+    Eigen::RowVectorXcd *cached = cf_cache.find(T);
+    if (cached != NULL) {
+        result = *cached;
+        return;
+    }
+
+    // March state to the last node before T (restart if it is already beyond), finish by a partial step on a copy
+    if (T < time) {
+        psi.setZero();
+        riccati = constant;
+        integral.setZero();
+        time = 0;
+    }
+    std::vector<double> steps;
+    Eigen::Array<bool, 1, Eigen::Dynamic> exploded = Eigen::Array<bool, 1, Eigen::Dynamic>::Constant(u.cols(), false);
+    double last_time = grid_steps(time, T, time_step, steps);
+    advance(constant, linear, steps, psi, riccati, integral, exploded);
+    time = last_time;
+    Eigen::ArrayXXcd end_psi = psi, end_riccati = riccati, end_integral = integral;
+    if (T > time) {
+        advance(constant, linear, std::vector<double>(1, T - time), end_psi, end_riccati, end_integral, exploded);
+    }
+
+    // ln phi = (v_0 + kappa*theta*sum c/x) * int F - kappa*theta * sum c/x psi_i(T)
+    Eigen::ArrayXd ratio = weights / nodes;
+    double level = v_0 + params.kappa * params.theta * ratio.sum();
+    Eigen::ArrayXXcd tail = (end_psi.colwise() * ratio.cast<std::complex<double> >()).colwise().sum();
+    result = (level * end_integral - (params.kappa * params.theta) * tail).matrix();
+    cf_cache.insert(T, result);
+}
+
+Eigen::Array<bool, 1, Eigen::Dynamic> RoughHestonModel::moments_exploded(const Eigen::RowVectorXd &omega, double T)
+{
+    // Argument u = -i*omega: F(u, 0) = omega(omega - 1)/2, linear term rho*sigma*omega - kappa
+    int columns = omega.cols();
+    Eigen::ArrayXXcd moment_constant = (0.5 * omega.array() * (omega.array() - 1)).cast<std::complex<double> >();
+    Eigen::ArrayXXcd moment_linear = (params.rho * params.sigma * omega.array() - params.kappa).cast<std::complex<double> >();
+    Eigen::ArrayXXcd moment_psi = Eigen::ArrayXXcd::Zero(factors, columns);
+    Eigen::ArrayXXcd moment_riccati = moment_constant;
+    Eigen::ArrayXXcd moment_integral = Eigen::ArrayXXcd::Zero(1, columns);
+    Eigen::Array<bool, 1, Eigen::Dynamic> exploded = Eigen::Array<bool, 1, Eigen::Dynamic>::Constant(columns, false);
+
+    std::vector<double> steps;
+    double last_time = grid_steps(0, T, time_step, steps);
+    advance(moment_constant, moment_linear, steps, moment_psi, moment_riccati, moment_integral, exploded);
+    if (T > last_time) {
+        std::vector<double> remainder(1, T - last_time);
+        advance(moment_constant, moment_linear, remainder, moment_psi, moment_riccati, moment_integral, exploded);
+    }
+    return exploded;
+}
+
+std::pair<double, double> RoughHestonModel::moment_strip(double T)
+{
+    std::pair<double, double> *cached = strip_cache.find(T);
+    if (cached != NULL) {
+        return *cached;
+    }
+
+    // Brackets [finite, exploded] of both sides by doubling: 2, 4, ... and -1, -2, ...
+    double infinity = std::numeric_limits<double>::infinity();
+    double finite[2] = {0, 1}, explosive[2] = {-infinity, infinity};
+    Eigen::RowVectorXd omega(2 * MOMENT_DOUBLINGS);
+    for (int k=0; k<MOMENT_DOUBLINGS; k++) {
+        omega[k] = -std::pow(2.0, k);
+        omega[MOMENT_DOUBLINGS + k] = std::pow(2.0, k + 1);
+    }
+    Eigen::Array<bool, 1, Eigen::Dynamic> exploded = moments_exploded(omega, T);
+    for (int side=0; side<2; side++) {
+        for (int k=0; k<MOMENT_DOUBLINGS; k++) {
+            if (exploded[side * MOMENT_DOUBLINGS + k]) {
+                explosive[side] = omega[side * MOMENT_DOUBLINGS + k];
+                break;
+            }
+            finite[side] = omega[side * MOMENT_DOUBLINGS + k];
+        }
+    }
+
+    // Multisection of finite brackets, orders of both sides are marched at once
+    omega.resize(2 * MOMENT_SECTIONS);
+    for (int pass=0; pass<MOMENT_PASSES; pass++) {
+        for (int side=0; side<2; side++) {
+            for (int k=0; k<MOMENT_SECTIONS; k++) {
+                double weight = (k + 1.0) / (MOMENT_SECTIONS + 1);
+                omega[side * MOMENT_SECTIONS + k] = std::isinf(explosive[side])
+                    ? finite[side] : finite[side] + weight * (explosive[side] - finite[side]);
+            }
+        }
+        exploded = moments_exploded(omega, T);
+        for (int side=0; side<2; side++) {
+            if (std::isinf(explosive[side])) {
+                continue;
+            }
+            double bound = explosive[side];
+            for (int k=0; k<MOMENT_SECTIONS; k++) {
+                if (exploded[side * MOMENT_SECTIONS + k]) {
+                    bound = omega[side * MOMENT_SECTIONS + k];
+                    break;
+                }
+                finite[side] = omega[side * MOMENT_SECTIONS + k];
+            }
+            explosive[side] = bound;
+        }
+    }
+
+    std::pair<double, double> result(
+        std::isinf(explosive[0]) ? explosive[0] : 0.5 * (finite[0] + explosive[0]),
+        std::isinf(explosive[1]) ? explosive[1] : 0.5 * (finite[1] + explosive[1])
+    );
+    strip_cache.insert(T, result);
+    return result;
+}
+
+void RoughHestonModel::set_params(const HestonParams &_params)
+{
+    params = _params;
+    reset();
+}
+
+HestonParams RoughHestonModel::get_params()
+{
+    return params;
+}
+
+void RoughHestonModel::set_hurst(double _hurst)
+{
+    if (!((_hurst > 0) && (_hurst < 0.5))) {
+        throw std::invalid_argument("Hurst exponent must be in (0, 1/2).");
+    }
+    hurst = _hurst;
+    set_kernel();
+}
+
+double RoughHestonModel::get_hurst()
+{
+    return hurst;
+}
+
+void RoughHestonModel::set_v0(double _v_0)
+{
+    if (_v_0 <= 0) {
+        throw std::invalid_argument("Starting volatility must be non-negative.");
+    }
+    v_0 = _v_0;
+    cf_cache.clear();
+}
+
+double RoughHestonModel::get_v0()
+{
+    return v_0;
+}
+
+void RoughHestonModel::set_discretization(int _factors, double _time_step)
+{
+    if (_factors < 2) {
+        throw std::invalid_argument("Factors count must be at least 2.");
+    }
+    if (_time_step <= 0) {
+        throw std::invalid_argument("Time step must be positive.");
+    }
+    factors = _factors;
+    time_step = _time_step;
+    set_kernel();
+}
+
+int RoughHestonModel::get_factors()
+{
+    return factors;
+}
+
+double RoughHestonModel::get_time_step()
+{
+    return time_step;
+}
+
+void RoughHestonModel::set_threads_count(int _threads_count)
+{
+    if (_threads_count <= 0) {
+        throw std::invalid_argument("Threads count must be positive.");
+    }
+    threads_count = _threads_count;
+}
+
+int RoughHestonModel::get_threads_count()
+{
+    return threads_count;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @brief Static arbitrage and numerical health checks of computed prices surfaces.
+ */
+#include "surface_checks.h"
+
+SurfaceChecker::SurfaceChecker(double _r, double _s_0, double _tolerance)
+{
+    if (_r <= 0) {
+        throw std::invalid_argument("Risk-free rate must be non-negative.");
+    }
+    if (_s_0 <= 0) {
+        throw std::invalid_argument("Starting spot price must be non-negative.");
+    }
+    r = _r; s_0 = _s_0;
+    set_tolerance(_tolerance);
+    Eigen::RowVectorXd whole(2);
+    whole << 0, std::numeric_limits<double>::infinity();
+    set_regions(whole);
+}
+
+void SurfaceChecker::set_tolerance(double _tolerance)
+{
+    if (_tolerance <= 0) {
+        throw std::invalid_argument("Tolerance must be positive.");
+    }
+    tolerance = _tolerance;
+}
+
+double SurfaceChecker::get_tolerance()
+{
+    return tolerance;
+}
+
+void SurfaceChecker::set_regions(const Eigen::RowVectorXd &_bounds)
+{
+    if ((_bounds.cols() < 2) || (_bounds.minCoeff() < 0)) {
+        throw std::invalid_argument("Regions must have at least 2 non-negative bounds.");
+    }
+    if ((_bounds.tail(_bounds.cols() - 1) - _bounds.head(_bounds.cols() - 1)).minCoeff() <= 0) {
+        throw std::invalid_argument("Regions bounds must be increasing.");
+    }
+    bounds = _bounds;
+}
+
+Eigen::RowVectorXd SurfaceChecker::get_regions()
+{
+    return bounds;
+}
+
+std::vector<SurfaceDiagnostics> SurfaceChecker::empty_diagnostics()
+{
+    std::vector<SurfaceDiagnostics> diagnostics(bounds.cols() - 1);
+    for (int i=0; i<(int)diagnostics.size(); i++) {
+        SurfaceDiagnostics &region = diagnostics[i];
+        region.K_lower = bounds[i];
+        region.K_upper = bounds[i + 1];
+        region.count = region.non_finite = region.monotonicity = region.convexity = region.parity = region.calendar = 0;
+        region.worst = 0;
+        region.worst_strike = region.worst_maturity = std::numeric_limits<double>::quiet_NaN();
+    }
+    return diagnostics;
+}
+
+void SurfaceChecker::accumulate(
+    const Eigen::RowVectorXd &amounts,
+    const Eigen::RowVectorXd &strikes,
+    double T,
+    int SurfaceDiagnostics::*counter,
+    std::vector<SurfaceDiagnostics> &diagnostics
+) {
+    // NaN amounts (of non-finite prices) are not violations of this check
+    Eigen::RowVectorXd violations = (amounts.array() > tolerance).select(amounts, 0.0);
+    const double *first = strikes.data();
+    const double *last = first + strikes.cols();
+    for (int i=0; i<(int)diagnostics.size(); i++) {
+        SurfaceDiagnostics &region = diagnostics[i];
+        int begin = std::lower_bound(first, last, region.K_lower) - first;
+        int end = std::lower_bound(first, last, region.K_upper) - first;
+        if (begin >= end) {
+            continue;
+        }
+
+        int index;
+        region.*counter += (violations.segment(begin, end - begin).array() > 0).count();
+        double worst = violations.segment(begin, end - begin).maxCoeff(&index);
+        if (worst > region.worst) {
+            region.worst = worst;
+            region.worst_strike = strikes[begin + index];
+            region.worst_maturity = T;
+        }
+    }
+}
+
+void SurfaceChecker::check_smile(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &calls,
+    double T,
+    std::vector<SurfaceDiagnostics> &diagnostics
+) {
+    typedef Eigen::Array<double, 1, Eigen::Dynamic> RowArrayXd;
+    int n = strikes.cols();
+    double df = std::exp(-r * T);
+    Eigen::RowVectorXd amounts;
+
+    // Checked prices count
+    for (int i=0; i<(int)diagnostics.size(); i++) {
+        diagnostics[i].count += (
+            (strikes.array() >= diagnostics[i].K_lower) && (strikes.array() < diagnostics[i].K_upper)
+        ).count();
+    }
+
+    // Non-finite values
+    amounts = calls.array().isFinite().select(
+        Eigen::RowVectorXd::Zero(n), Eigen::RowVectorXd::Constant(n, std::numeric_limits<double>::infinity())
+    );
+    accumulate(amounts, strikes, T, &SurfaceDiagnostics::non_finite, diagnostics);
+
+    // Call-Put Parity bounds: put and call prices are non-negative, call is not greater than spot
+    RowArrayXd lower = (s_0 - df * strikes.array()).max(0.0);
+    amounts = (lower - calls.array()).max(calls.array() - s_0).matrix();
+    accumulate(amounts, strikes, T, &SurfaceDiagnostics::parity, diagnostics);
+    if (n < 2) {
+        return;
+    }
+
+    // Call spreads: 0 <= C(K_j) - C(K_{j+1}) <= B(0,T)(K_{j+1} - K_j)
+    RowArrayXd d_K = strikes.tail(n - 1) - strikes.head(n - 1);
+    RowArrayXd d_C = calls.tail(n - 1) - calls.head(n - 1);
+    amounts.setZero();
+    amounts.head(n - 1) = d_C.max(-df * d_K - d_C).matrix();
+    accumulate(amounts, strikes, T, &SurfaceDiagnostics::monotonicity, diagnostics);
+    if (n < 3) {
+        return;
+    }
+
+    // Butterflies on non-uniform grid: C(K_j) <= l C(K_{j-1}) + (1 - l) C(K_{j+1}), l = (K_{j+1} - K_j)/(K_{j+1} - K_{j-1})
+    RowArrayXd weight = d_K.tail(n - 2) / (d_K.head(n - 2) + d_K.tail(n - 2));
+    amounts.setZero();
+    amounts.segment(1, n - 2) = (
+        calls.segment(1, n - 2).array() - weight * calls.head(n - 2).array() - (1 - weight) * calls.tail(n - 2).array()
+    ).matrix();
+    accumulate(amounts, strikes, T, &SurfaceDiagnostics::convexity, diagnostics);
+}
+
+std::vector<SurfaceDiagnostics> SurfaceChecker::check(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &prices,
+    double T,
+    bool is_call
+) {
+    Eigen::RowVectorXd maturities(1);
+    maturities << T;
+    return check(strikes, maturities, prices, is_call);
+}
+
+std::vector<SurfaceDiagnostics> SurfaceChecker::check(
+    const Eigen::RowVectorXd &strikes,
+    const Eigen::RowVectorXd &maturities,
+    const Eigen::MatrixXd &prices,
+    bool is_call
+) {
+    int n = strikes.cols();
+    int m = maturities.cols();
+    if ((prices.rows() != m) || (prices.cols() != n)) {
+        throw std::invalid_argument("Prices must be of shape (maturities count) x (strikes count).");
+    }
+    if ((n > 1) && ((strikes.tail(n - 1) - strikes.head(n - 1)).minCoeff() <= 0)) {
+        throw std::invalid_argument("Strikes must be increasing.");
+    }
+    if ((m > 0) && (maturities.minCoeff() <= 0)) {
+        throw std::invalid_argument("Maturities must be positive.");
+    }
+    if ((m > 1) && ((maturities.tail(m - 1) - maturities.head(m - 1)).minCoeff() <= 0)) {
+        throw std::invalid_argument("Maturities must be increasing.");
+    }
+
+    std::vector<SurfaceDiagnostics> diagnostics = empty_diagnostics();
+    Eigen::RowVectorXd previous;
+    for (int t=0; t<m; t++) {
+        // If options are of put type, use the Put-Call parity
+        Eigen::RowVectorXd calls = prices.row(t);
+        if (!is_call) {
+            calls = (calls.array() + s_0 - std::exp(-r * maturities[t]) * strikes.array()).matrix();
+        }
+        check_smile(strikes, calls, maturities[t], diagnostics);
+
+        // Calendar spreads: C(K, T_t) >= C(K, T_{t-1}) without dividends
+        if (t > 0) {
+            accumulate(previous - calls, strikes, maturities[t], &SurfaceDiagnostics::calendar, diagnostics);
+        }
+        previous = calls;
+    }
+    return diagnostics;
+}
+
+bool SurfaceChecker::passed(const std::vector<SurfaceDiagnostics> &diagnostics)
+{
+    for (int i=0; i<(int)diagnostics.size(); i++) {
+        const SurfaceDiagnostics &region = diagnostics[i];
+        if (region.non_finite + region.monotonicity + region.convexity + region.parity + region.calendar > 0) {
+            return false;
+        }
+    }
+    return true;
+}